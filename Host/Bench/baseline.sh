@@ -0,0 +1,51 @@
+#!/bin/sh
+#
+# Builds main_bench.c with avr-gcc in two variants (new modules, and with -DBENCH_LIBC the
+# previous code using float and libc) and records a baseline: per variant the avr-size output
+# and the largest symbols (avr-nm --size-sort) as '#' lines, followed by the CSV lines
+# main_bench sends over USART3. The rows "flash" and "flash_libc" give the program size of
+# both variants; their difference is the flash saved by Convert, Format and Parse.
+#
+#   Host/Bench/baseline.sh /dev/ttyACM0 [file]     (default: Host/Bench/baseline.csv)
+#
+# Compare a later run against the committed file with diff. Program the board with
+# each printed .hex (e.g. pymcuprog write -d avr128db48 -f <hex> --erase) while the
+# script waits for the "ende" line.
+#
+# Mikroprozessortechnik
+# Technische Hochschule Mittelhessen
+
+cd "$(dirname "$0")/../.." || exit 1
+PORT="${1:?serial port, e.g. /dev/ttyACM0}"
+FILE="${2:-Host/Bench/baseline.csv}"
+OUT="${TMPDIR:-/tmp}/main_bench"
+MODULES="USART ADC RTC AVR128DB48_I2C I2C_LCD Format Parse Convert Filter Temperature"
+SYMBOLS=20		# Largest symbols listed per variant
+mkdir -p "$OUT"
+
+INC=""
+SRC=""
+for module in $MODULES; do
+	INC="$INC -IInclude/$module"
+	SRC="$SRC Include/$module/$module.c"
+done
+
+: > "$FILE"
+for variant in main_bench main_bench_libc; do
+	FLAGS=""
+	[ "$variant" = main_bench_libc ] && FLAGS="-DBENCH_LIBC"
+	avr-gcc -mmcu=avr128db48 -std=gnu11 -Os -Wall -ffunction-sections -fdata-sections -Wl,--gc-sections \
+		$FLAGS $INC main_bench.c $SRC -o "$OUT/$variant.elf" || exit 1
+	avr-objcopy -O ihex -R .eeprom "$OUT/$variant.elf" "$OUT/$variant.hex" || exit 1
+
+	echo "# $variant" >> "$FILE"
+	avr-size -C --mcu=avr128db48 "$OUT/$variant.elf" | sed 's/^/# /' >> "$FILE"
+	avr-nm --size-sort -S -t d "$OUT/$variant.elf" | tail -n "$SYMBOLS" | sed 's/^/# /' >> "$FILE"
+done
+
+stty -F "$PORT" 9600 cs8 -parenb -cstopb raw -echo || exit 1
+for variant in main_bench main_bench_libc; do
+	echo "Program $OUT/$variant.hex, waiting for the results on $PORT"
+	sed -n '/^name,/,/^ende/{p;/^ende/q}' < "$PORT" | tr -d '\r' >> "$FILE"
+done
+cat "$FILE"
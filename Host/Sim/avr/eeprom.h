@@ -0,0 +1,47 @@
+/*
+ ***********************************************************************************
+ * @file:   avr/eeprom.h (host simulation)
+ * @date:   17.10.2026
+ *
+ * EEPROM access of avr-libc. Variables declared with EEMEM are collected in the
+ * section sim_eeprom, which reads 0xFF (erased) at program start. With the environment
+ * variable SIM_EEPROM=<file> its content is loaded from the file at start and saved
+ * after every write, so it survives a "power cycle" (the next run of the program).
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+
+#ifndef SIM_AVR_EEPROM_H_
+#define SIM_AVR_EEPROM_H_
+
+// INCLUDES //
+#include <stdint.h>
+#include <stddef.h>
+
+// DEFINES //
+#define EEMEM					__attribute__((section("sim_eeprom")))
+
+#define eeprom_is_ready()		1
+#define eeprom_busy_wait()		do {} while (0)
+
+// FUNCTION DECLARATIONS //
+void eeprom_read_block(void* destination, const void* source, size_t length);
+
+void eeprom_write_block(const void* source, void* destination, size_t length);
+
+void eeprom_update_block(const void* source, void* destination, size_t length);
+
+uint8_t eeprom_read_byte(const uint8_t* address);
+
+void eeprom_write_byte(uint8_t* address, uint8_t value);
+
+void eeprom_update_byte(uint8_t* address, uint8_t value);
+
+
+#endif /* SIM_AVR_EEPROM_H_ */
@@ -0,0 +1,36 @@
+/*
+ ***********************************************************************************
+ * @file:   avr/interrupt.h (host simulation)
+ * @date:   17.10.2026
+ *
+ * ISR() defines an ordinary function that the models call on the firmware thread.
+ * sei() / cli() set and clear the I-Bit in SREG; pending interrupts run on sei().
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+// INCLUDES //
+#include <avr/io.h>
+
+// DEFINES //
+#define ISR(vector, ...)	void vector(void); void vector(void)
+
+#define sei()				sim_sei()
+#define cli()				sim_cli()
+
+// FUNCTION DECLARATIONS //
+void sim_sei(void);
+
+void sim_cli(void);
+
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
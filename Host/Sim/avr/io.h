@@ -0,0 +1,380 @@
+/*
+ ***********************************************************************************
+ * @file:   avr/io.h (host simulation)
+ * @date:   17.10.2026
+ *
+ * Replacement of <avr/io.h> for building the firmware on a PC. Declares the
+ * peripherals of the AVR128DB48 used by this project as plain structs; the models
+ * in sim.c read and write them from a second thread.
+ *
+ * Only the registers and bit names used by the firmware are provided; the values
+ * follow the AVR128DB48 device header. Layout and addresses are NOT those of the
+ * device. Registers whose write has a side effect (TXDATAL, MADDR, MDATA, MCTRLB)
+ * are 16 Bit wide here: the models load them with SIM_UNWRITTEN and detect a write
+ * of the firmware by a value below 0x100.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+// INCLUDES //
+#include <stdint.h>
+
+// TYPES //
+typedef volatile uint8_t register8_t;
+typedef volatile uint16_t register16_t;
+
+#define SIM_UNWRITTEN	0xFFFF		// Value of a write-detecting register nobody has written to
+
+typedef struct {
+	register8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLE, SAMPCTRL;
+	register8_t MUXPOS, MUXNEG, COMMAND, EVCTRL, INTCTRL, INTFLAGS, DBGCTRL, TEMP;
+	register16_t RES, WINLT, WINHT;
+} ADC_t;
+
+typedef struct {
+	register8_t ADC0REF, DAC0REF, ACREF;
+} VREF_t;
+
+typedef struct {
+	register8_t RXDATAL, RXDATAH;
+	register16_t TXDATAL;			// Write-detecting
+	register8_t TXDATAH, STATUS, CTRLA, CTRLB, CTRLC;
+	register16_t BAUD;
+	register8_t CTRLD, DBGCTRL, EVCTRL, TXPLCTRL, RXPLCTRL;
+} USART_t;
+
+typedef struct {
+	register8_t CTRLA, DUALCTRL, DBGCTRL, MCTRLA;
+	register16_t MCTRLB;			// Write-detecting
+	register8_t MSTATUS, MBAUD;
+	register16_t MADDR, MDATA;		// Write-detecting
+} TWI_t;
+
+typedef struct {
+	register8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLECLR, CTRLESET, CTRLFCLR, CTRLFSET;
+	register8_t EVCTRL, INTCTRL, INTFLAGS, DBGCTRL, TEMP;
+	register16_t CNT, PER, CMP0, CMP1, CMP2;
+} TCA_SINGLE_t;
+
+typedef union {
+	TCA_SINGLE_t SINGLE;
+} TCA_t;
+
+typedef struct {
+	register8_t CTRLA, CTRLB, reserved_0x02, reserved_0x03, EVCTRL, INTCTRL, INTFLAGS, STATUS, DBGCTRL, TEMP;
+	register16_t CNT, CCMP;
+} TCB_t;
+
+typedef struct {
+	register8_t CTRLA, STATUS, INTCTRL, INTFLAGS, TEMP, DBGCTRL, CALIB, CLKSEL;
+	register16_t CNT, PER, CMP;
+	register8_t PITCTRLA, PITSTATUS, PITINTCTRL, PITINTFLAGS, PITDBGCTRL, PITEVGENCTRLA;
+} RTC_t;
+
+typedef struct {
+	register8_t DIR, DIRSET, DIRCLR, DIRTGL, OUT, OUTSET, OUTCLR, OUTTGL, IN, INTFLAGS;
+	register8_t PORTCTRL, PINCONFIG, PINCTRLUPD, PINCTRLSET, PINCTRLCLR;
+	register8_t PIN0CTRL, PIN1CTRL, PIN2CTRL, PIN3CTRL, PIN4CTRL, PIN5CTRL, PIN6CTRL, PIN7CTRL;
+} PORT_t;
+
+typedef struct {
+	register8_t EVSYSROUTEA, CCLROUTEA, USARTROUTEA, USARTROUTEB, SPIROUTEA, TWIROUTEA;
+	register8_t TCAROUTEA, TCBROUTEA, TCDROUTEA, ACROUTEA, ZCDROUTEA;
+} PORTMUX_t;
+
+typedef struct {
+	register8_t CTRLA, VREGCTRL;
+} SLPCTRL_t;
+
+typedef struct {				// Channels and the users needed here (layout differs from the device)
+	register8_t SWEVENTA, SWEVENTB;
+	register8_t CHANNEL0, CHANNEL1, CHANNEL2, CHANNEL3, CHANNEL4, CHANNEL5, CHANNEL6, CHANNEL7, CHANNEL8, CHANNEL9;
+	register8_t USERADC0START, USERTCB0COUNT;
+} EVSYS_t;
+
+typedef struct {
+	register8_t DEVICEID0, DEVICEID1, DEVICEID2;
+	register16_t TEMPSENSE0, TEMPSENSE1;
+	register8_t SERNUM[16];
+} SIGROW_t;
+
+// PERIPHERALS //
+extern ADC_t ADC0;
+extern VREF_t VREF;
+extern USART_t USART3;
+extern TWI_t TWI0;
+extern TCA_t TCA0, TCA1;
+extern TCB_t TCB0;
+extern EVSYS_t EVSYS;
+extern SLPCTRL_t SLPCTRL;
+extern RTC_t RTC;
+extern PORT_t PORTA, PORTB, PORTC, PORTD, PORTE, PORTF;
+extern PORTMUX_t PORTMUX;
+extern SIGROW_t SIGROW;
+
+extern volatile uint8_t sim_sreg;
+#define SREG			sim_sreg
+#define CPU_I_bm		0x80
+
+#define _BV(bit)		(1 << (bit))
+
+// INTERRUPT VECTORS (ISR() defines a function of this name, called by the models) //
+#define PORTA_PORT_vect		sim_vector_PORTA_PORT
+#define PORTB_PORT_vect		sim_vector_PORTB_PORT
+#define PORTC_PORT_vect		sim_vector_PORTC_PORT
+#define PORTD_PORT_vect		sim_vector_PORTD_PORT
+#define PORTE_PORT_vect		sim_vector_PORTE_PORT
+#define PORTF_PORT_vect		sim_vector_PORTF_PORT
+#define RTC_CNT_vect		sim_vector_RTC_CNT
+#define RTC_PIT_vect		sim_vector_RTC_PIT
+#define TCA0_OVF_vect		sim_vector_TCA0_OVF
+#define TWI0_TWIM_vect		sim_vector_TWI0_TWIM
+#define ADC0_RESRDY_vect	sim_vector_ADC0_RESRDY
+#define USART3_RXC_vect		sim_vector_USART3_RXC
+#define USART3_DRE_vect		sim_vector_USART3_DRE
+
+// PORT //
+#define PIN0_bm		0x01
+#define PIN1_bm		0x02
+#define PIN2_bm		0x04
+#define PIN3_bm		0x08
+#define PIN4_bm		0x10
+#define PIN5_bm		0x20
+#define PIN6_bm		0x40
+#define PIN7_bm		0x80
+
+#define PORT_ISC_gm				0x07
+#define PORT_ISC_INTDISABLE_gc	0x00
+#define PORT_ISC_BOTHEDGES_gc	0x01
+#define PORT_ISC_RISING_gc		0x02
+#define PORT_ISC_FALLING_gc		0x03
+#define PORT_ISC_INPUT_DISABLE_gc	0x04
+#define PORT_ISC_LEVEL_gc		0x05
+#define PORT_PULLUPEN_bm		0x08
+#define PORT_INVEN_bm			0x80
+
+#define PORTMUX_TCA0_gm			0x07
+#define PORTMUX_TCA0_PORTA_gc	0x00
+#define PORTMUX_TCA0_PORTB_gc	0x01
+#define PORTMUX_TCA0_PORTC_gc	0x02
+#define PORTMUX_TCA0_PORTD_gc	0x03
+#define PORTMUX_TCA0_PORTE_gc	0x04
+#define PORTMUX_TCA0_PORTF_gc	0x05
+
+// ADC //
+#define ADC_ENABLE_bm			0x01
+#define ADC_FREERUN_bm			0x02
+#define ADC_RESSEL_gm			0x0C
+#define ADC_RESSEL_12BIT_gc		0x00
+#define ADC_RESSEL_10BIT_gc		0x04
+#define ADC_LEFTADJ_bm			0x10
+#define ADC_CONVMODE_bm			0x20
+#define ADC_RUNSTBY_bm			0x80
+
+#define ADC_SAMPNUM_gm			0x07
+#define ADC_SAMPNUM_NONE_gc		0x00
+#define ADC_SAMPNUM_ACC2_gc		0x01
+#define ADC_SAMPNUM_ACC4_gc		0x02
+#define ADC_SAMPNUM_ACC8_gc		0x03
+#define ADC_SAMPNUM_ACC16_gc	0x04
+#define ADC_SAMPNUM_ACC32_gc	0x05
+#define ADC_SAMPNUM_ACC64_gc	0x06
+#define ADC_SAMPNUM_ACC128_gc	0x07
+
+#define ADC_PRESC_gm			0x0F
+#define ADC_PRESC_DIV2_gc		0x00
+#define ADC_PRESC_DIV4_gc		0x01
+#define ADC_PRESC_DIV6_gc		0x02
+#define ADC_PRESC_DIV8_gc		0x03
+#define ADC_PRESC_DIV10_gc		0x04
+#define ADC_PRESC_DIV12_gc		0x05
+#define ADC_PRESC_DIV14_gc		0x06
+#define ADC_PRESC_DIV16_gc		0x07
+#define ADC_PRESC_DIV20_gc		0x08
+#define ADC_PRESC_DIV24_gc		0x09
+#define ADC_PRESC_DIV28_gc		0x0A
+#define ADC_PRESC_DIV32_gc		0x0B
+#define ADC_PRESC_DIV40_gc		0x0C
+#define ADC_PRESC_DIV48_gc		0x0D
+#define ADC_PRESC_DIV56_gc		0x0E
+#define ADC_PRESC_DIV64_gc		0x0F
+
+#define ADC_INITDLY_gm			0xE0
+#define ADC_INITDLY_DLY0_gc		0x00
+#define ADC_INITDLY_DLY16_gc	0x20
+#define ADC_INITDLY_DLY32_gc	0x40
+#define ADC_INITDLY_DLY64_gc	0x60
+#define ADC_INITDLY_DLY128_gc	0x80
+#define ADC_INITDLY_DLY256_gc	0xA0
+
+#define ADC_MUXPOS_gm			0x7F
+#define ADC_MUXPOS_AIN0_gc		0x00
+#define ADC_MUXPOS_AIN16_gc		0x10
+#define ADC_MUXPOS_AIN17_gc		0x11
+#define ADC_MUXPOS_AIN18_gc		0x12
+#define ADC_MUXPOS_AIN19_gc		0x13
+#define ADC_MUXPOS_AIN20_gc		0x14
+#define ADC_MUXPOS_AIN21_gc		0x15
+#define ADC_MUXPOS_GND_gc		0x40
+#define ADC_MUXPOS_TEMPSENSE_gc	0x42
+
+#define ADC_STCONV_bm			0x01
+#define ADC_SPCONV_bm			0x02
+#define ADC_STARTEI_bm			0x01
+#define ADC_RESRDY_bm			0x01
+#define ADC_WCMP_bm				0x02
+
+// VREF //
+#define VREF_REFSEL_gm			0x07
+#define VREF_REFSEL_1V024_gc	0x00
+#define VREF_REFSEL_2V048_gc	0x01
+#define VREF_REFSEL_4V096_gc	0x02
+#define VREF_REFSEL_2V500_gc	0x03
+#define VREF_REFSEL_VDD_gc		0x05
+#define VREF_REFSEL_VREFA_gc	0x06
+#define VREF_ALWAYSON_bm		0x80
+
+// EVSYS //
+#define EVSYS_CHANNEL0_OFF_gc				0x00
+#define EVSYS_CHANNEL0_TCA0_OVF_LUNF_gc		0x80
+#define EVSYS_CHANNEL0_TCA1_OVF_LUNF_gc		0x88
+#define EVSYS_USER_OFF_gc					0x00
+#define EVSYS_USER_CHANNEL0_gc				0x01
+
+// SLPCTRL //
+#define SLPCTRL_SEN_bm				0x01
+#define SLPCTRL_SMODE_gm			0x06
+#define SLPCTRL_SMODE_IDLE_gc		0x00
+#define SLPCTRL_SMODE_STDBY_gc		0x02
+#define SLPCTRL_SMODE_PDOWN_gc		0x04
+
+// RTC //
+#define RTC_RTCEN_bm			0x01
+#define RTC_PRESCALER_gm		0x78
+#define RTC_PRESCALER_DIV1_gc	0x00
+#define RTC_PRESCALER_DIV2_gc	0x08
+#define RTC_PRESCALER_DIV4_gc	0x10
+#define RTC_PRESCALER_DIV8_gc	0x18
+#define RTC_PRESCALER_DIV16_gc	0x20
+#define RTC_PRESCALER_DIV32_gc	0x28
+#define RTC_PRESCALER_DIV64_gc	0x30
+#define RTC_PRESCALER_DIV128_gc	0x38
+#define RTC_RUNSTDBY_bm			0x80
+#define RTC_CLKSEL_gm			0x03
+#define RTC_CLKSEL_OSC32K_gc	0x00
+#define RTC_CLKSEL_XOSC32K_gc	0x01
+#define RTC_CLKSEL_EXTCLK_gc	0x03
+#define RTC_OVF_bm				0x01
+#define RTC_CMP_bm				0x02
+#define RTC_PITEN_bm			0x01
+#define RTC_PERIOD_gm			0x78
+#define RTC_PERIOD_OFF_gc		0x00
+#define RTC_PERIOD_CYC4_gc		0x08
+#define RTC_PERIOD_CYC8_gc		0x10
+#define RTC_PERIOD_CYC16_gc		0x18
+#define RTC_PERIOD_CYC32_gc		0x20
+#define RTC_PERIOD_CYC64_gc		0x28
+#define RTC_PERIOD_CYC128_gc	0x30
+#define RTC_PERIOD_CYC256_gc	0x38
+#define RTC_PERIOD_CYC512_gc	0x40
+#define RTC_PERIOD_CYC1024_gc	0x48
+#define RTC_PERIOD_CYC2048_gc	0x50
+#define RTC_PERIOD_CYC4096_gc	0x58
+#define RTC_PERIOD_CYC8192_gc	0x60
+#define RTC_PERIOD_CYC16384_gc	0x68
+#define RTC_PERIOD_CYC32768_gc	0x70
+#define RTC_PI_bm				0x01
+
+// TCA //
+#define TCA_SINGLE_ENABLE_bm			0x01
+#define TCA_SINGLE_CLKSEL_gm			0x0E
+#define TCA_SINGLE_CLKSEL_DIV1_gc		0x00
+#define TCA_SINGLE_CLKSEL_DIV2_gc		0x02
+#define TCA_SINGLE_CLKSEL_DIV4_gc		0x04
+#define TCA_SINGLE_CLKSEL_DIV8_gc		0x06
+#define TCA_SINGLE_CLKSEL_DIV16_gc		0x08
+#define TCA_SINGLE_CLKSEL_DIV64_gc		0x0A
+#define TCA_SINGLE_CLKSEL_DIV256_gc		0x0C
+#define TCA_SINGLE_CLKSEL_DIV1024_gc	0x0E
+#define TCA_SINGLE_RUNSTDBY_bm			0x80
+#define TCA_SINGLE_WGMODE_gm			0x07
+#define TCA_SINGLE_WGMODE_NORMAL_gc		0x00
+#define TCA_SINGLE_WGMODE_FRQ_gc		0x01
+#define TCA_SINGLE_WGMODE_SINGLESLOPE_gc	0x03
+#define TCA_SINGLE_CMP0EN_bm			0x10
+#define TCA_SINGLE_CMP1EN_bm			0x20
+#define TCA_SINGLE_CMP2EN_bm			0x40
+#define TCA_SINGLE_OVF_bm				0x01
+#define TCA_SINGLE_CMP0_bm				0x10
+#define TCA_SINGLE_CMP1_bm				0x20
+#define TCA_SINGLE_CMP2_bm				0x40
+
+// TCB //
+#define TCB_ENABLE_bm			0x01
+#define TCB_CLKSEL_gm			0x0E
+#define TCB_CLKSEL_DIV1_gc		0x00
+#define TCB_CLKSEL_EVENT_gc		0x0E
+#define TCB_CNTMODE_gm			0x07
+#define TCB_CNTMODE_INT_gc		0x00
+
+// USART //
+#define USART_RXCIF_bm			0x80
+#define USART_TXCIF_bm			0x40
+#define USART_DREIF_bm			0x20
+#define USART_RXCIE_bm			0x80
+#define USART_TXCIE_bm			0x40
+#define USART_DREIE_bm			0x20
+#define USART_RXEN_bm			0x80
+#define USART_TXEN_bm			0x40
+#define USART_LBME_bm			0x08
+#define USART_RXMODE_gm			0x06
+#define USART_RXMODE_NORMAL_gc	0x00
+#define USART_RXMODE_CLK2X_gc	0x02
+#define USART_CHSIZE_gm			0x07
+#define USART_CHSIZE_8BIT_gc	0x03
+#define USART_BUFOVF_bm			0x40
+#define USART_FERR_bm			0x04
+
+// TWI //
+#define TWI_FMPEN_bm			0x02
+#define TWI_SDAHOLD_gm			0x0C
+#define TWI_SDAHOLD_OFF_gc		0x00
+#define TWI_SDAHOLD_50NS_gc		0x04
+#define TWI_SDAHOLD_300NS_gc	0x08
+#define TWI_SDAHOLD_500NS_gc	0x0C
+#define TWI_DBGRUN_bm			0x01
+#define TWI_ENABLE_bm			0x01
+#define TWI_SMEN_bm				0x02
+#define TWI_WIEN_bm				0x40
+#define TWI_RIEN_bm				0x80
+#define TWI_MCMD_gm				0x03
+#define TWI_MCMD_NOACT_gc		0x00
+#define TWI_MCMD_REPSTART_gc	0x01
+#define TWI_MCMD_RECVTRANS_gc	0x02
+#define TWI_MCMD_STOP_gc		0x03
+#define TWI_ACKACT_bm			0x04
+#define TWI_ACKACT_ACK_gc		0x00
+#define TWI_ACKACT_NACK_gc		0x04
+#define TWI_BUSSTATE_gm			0x03
+#define TWI_BUSSTATE_UNKNOWN_gc	0x00
+#define TWI_BUSSTATE_IDLE_gc	0x01
+#define TWI_BUSSTATE_OWNER_gc	0x02
+#define TWI_BUSSTATE_BUSY_gc	0x03
+#define TWI_BUSERR_bm			0x04
+#define TWI_ARBLOST_bm			0x08
+#define TWI_RXACK_bm			0x10
+#define TWI_CLKHOLD_bm			0x20
+#define TWI_WIF_bm				0x40
+#define TWI_RIF_bm				0x80
+
+
+#endif /* SIM_AVR_IO_H_ */
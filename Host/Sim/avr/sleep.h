@@ -0,0 +1,43 @@
+/*
+ ***********************************************************************************
+ * @file:   avr/sleep.h (host simulation)
+ * @date:   17.10.2026
+ *
+ * Sleep macros of avr-libc. sleep_cpu() waits until an ISR has run, counted from
+ * sleep_enable(), so an interrupt taken by the sei() right before sleep_cpu() wakes
+ * it at once like on the device. All sleep modes behave like idle: the models keep
+ * running.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+
+#ifndef SIM_AVR_SLEEP_H_
+#define SIM_AVR_SLEEP_H_
+
+// INCLUDES //
+#include <avr/io.h>
+
+// DEFINES //
+#define SLEEP_MODE_IDLE			SLPCTRL_SMODE_IDLE_gc
+#define SLEEP_MODE_STANDBY		SLPCTRL_SMODE_STDBY_gc
+#define SLEEP_MODE_PWR_DOWN		SLPCTRL_SMODE_PDOWN_gc
+
+#define set_sleep_mode(mode)	(SLPCTRL.CTRLA = (uint8_t)((SLPCTRL.CTRLA & ~SLPCTRL_SMODE_gm) | (mode)))
+#define sleep_enable()			sim_sleepEnable()
+#define sleep_disable()			(SLPCTRL.CTRLA &= (uint8_t)~SLPCTRL_SEN_bm)
+#define sleep_cpu()				sim_sleep()
+#define sleep_mode()			do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+
+// FUNCTION DECLARATIONS //
+void sim_sleepEnable(void);
+
+void sim_sleep(void);
+
+
+#endif /* SIM_AVR_SLEEP_H_ */
@@ -0,0 +1,1240 @@
+/*
+ ***********************************************************************************
+ * @file:   sim.c
+ * @date:   17.10.2026
+ *
+ * Behavioral models of the AVR128DB48 peripherals for running the firmware on a PC.
+ *
+ * The model thread owns the simulated clock. Each step it applies the register
+ * writes of the firmware, advances the peripherals and marks interrupts as pending.
+ * A pending interrupt is signalled (SIGUSR1) to the firmware thread, whose handler
+ * calls the ISR if the I-Bit in SREG is set. The ISR runs under the model lock, so
+ * the models see all of its register writes at once when it has returned; interrupt
+ * flags that the ISR would clear by writing a one are cleared by the model afterwards.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#define _GNU_SOURCE
+#include "sim.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <util/delay.h>
+#include <avr/sleep.h>
+#include <avr/eeprom.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <math.h>
+
+// DEFINES //
+#define RX_QUEUE_SIZE		4096
+#define STDIN_POLL_NS		1000000ULL		// Look for input on stdin every 1ms
+#define LCD_SETTLE_NS		200000000ULL	// Print the display once it has not changed for 200ms
+
+#define TWI_STATUS_FLAGS	(TWI_RIF_bm | TWI_WIF_bm | TWI_CLKHOLD_bm | TWI_ARBLOST_bm | TWI_BUSERR_bm)
+
+#define LCD_RS				0x01			// PCF8574 pins of the HW-061 backpack
+#define LCD_RW				0x02
+#define LCD_E				0x04
+
+#define LCD_EXEC_NS			37000ULL		// Execution times (HD44780 Datasheet, Table 6)
+#define LCD_DATA_NS			41000ULL
+#define LCD_CLEAR_NS		1520000ULL
+
+// ENUMS //
+typedef enum {			// Interrupt sources in order of their vector number (priority)
+	IRQ_PORTA,
+	IRQ_PORTB,
+	IRQ_PORTC,
+	IRQ_PORTD,
+	IRQ_PORTE,
+	IRQ_PORTF,
+	IRQ_RTC_CNT,
+	IRQ_RTC_PIT,
+	IRQ_TCA0_OVF,
+	IRQ_TWI0_TWIM,
+	IRQ_ADC0_RESRDY,
+	IRQ_USART3_RXC,
+	IRQ_USART3_DRE,
+	IRQ_COUNT
+} irq;
+
+typedef enum {
+	TWI_NONE,
+	TWI_ADDRESS,
+	TWI_WRITE,
+	TWI_READ
+} twi_phase;
+
+// PERIPHERALS //
+ADC_t ADC0;
+VREF_t VREF;
+USART_t USART3 = { .TXDATAL = SIM_UNWRITTEN };
+TWI_t TWI0 = { .MCTRLB = SIM_UNWRITTEN, .MADDR = SIM_UNWRITTEN, .MDATA = SIM_UNWRITTEN };
+TCA_t TCA0 = { .SINGLE = { .PER = 0xFFFF } };
+TCA_t TCA1 = { .SINGLE = { .PER = 0xFFFF } };
+TCB_t TCB0;
+EVSYS_t EVSYS;
+SLPCTRL_t SLPCTRL;
+RTC_t RTC = { .PER = 0xFFFF };
+PORT_t PORTA, PORTB, PORTC, PORTD, PORTE, PORTF;
+PORTMUX_t PORTMUX;
+SIGROW_t SIGROW = { .TEMPSENSE0 = 3500, .TEMPSENSE1 = 2500 };	// Example calibration (slope, offset)
+
+volatile uint8_t sim_sreg = 0;
+
+// ISR() functions of the firmware; a missing one is NULL //
+extern void sim_vector_PORTA_PORT(void) __attribute__((weak));
+extern void sim_vector_PORTB_PORT(void) __attribute__((weak));
+extern void sim_vector_PORTC_PORT(void) __attribute__((weak));
+extern void sim_vector_PORTD_PORT(void) __attribute__((weak));
+extern void sim_vector_PORTE_PORT(void) __attribute__((weak));
+extern void sim_vector_PORTF_PORT(void) __attribute__((weak));
+extern void sim_vector_RTC_CNT(void) __attribute__((weak));
+extern void sim_vector_RTC_PIT(void) __attribute__((weak));
+extern void sim_vector_TCA0_OVF(void) __attribute__((weak));
+extern void sim_vector_TWI0_TWIM(void) __attribute__((weak));
+extern void sim_vector_ADC0_RESRDY(void) __attribute__((weak));
+extern void sim_vector_USART3_RXC(void) __attribute__((weak));
+extern void sim_vector_USART3_DRE(void) __attribute__((weak));
+
+static void (*const vectors[IRQ_COUNT])(void) = {
+	sim_vector_PORTA_PORT, sim_vector_PORTB_PORT, sim_vector_PORTC_PORT,
+	sim_vector_PORTD_PORT, sim_vector_PORTE_PORT, sim_vector_PORTF_PORT,
+	sim_vector_RTC_CNT, sim_vector_RTC_PIT, sim_vector_TCA0_OVF, sim_vector_TWI0_TWIM,
+	sim_vector_ADC0_RESRDY, sim_vector_USART3_RXC, sim_vector_USART3_DRE
+};
+
+// Variables //
+static pthread_t firmware_thread;
+static pthread_t model_thread;
+static uint32_t pending = 0;				// One bit per irq, cleared when the ISR has returned
+static uint64_t now_ns = 0;					// Simulated time
+static uint32_t lock_next = 0;				// Ticket lock between model thread, ISRs and API calls
+static uint32_t lock_serving = 0;
+static __thread bool in_api = false;		// This thread holds the lock for an API call
+static volatile uint32_t isr_count = 0;		// ISRs run so far (firmware thread only)
+static uint32_t sleep_start = 0;			// isr_count at sleep_enable()
+
+static bool realtime = false;
+static uint64_t time_limit_ns = 0;
+static struct timespec start_time;
+
+// EEMEM variables, placed by the linker between these symbols (none without EEMEM) //
+extern uint8_t __start_sim_eeprom[] __attribute__((weak));
+extern uint8_t __stop_sim_eeprom[] __attribute__((weak));
+static const char* eeprom_file = NULL;
+
+static PORT_t* const ports[] = { &PORTA, &PORTB, &PORTC, &PORTD, &PORTE, &PORTF };
+static struct {
+	uint8_t input[6];						// Levels applied to the pins from outside
+	uint8_t previous[6];					// IN of the previous step for edge detection
+	uint8_t flags[6];						// INTFLAGS as set by the model, to detect firmware writes
+	bool raised[6];
+} port;
+
+static struct {
+	uint64_t accumulator;
+	bool raised;
+} rtc, pit, tca[2];
+
+static TCA_t* const timers[] = { &TCA0, &TCA1 };
+
+static struct {
+	sim_waveform waveform[128];
+	void* context[128];
+	bool converting;
+	uint64_t start_ns;
+	uint64_t done_ns;
+	uint8_t muxpos;
+	uint8_t refsel;
+	uint8_t last_refsel;
+	uint8_t sampnum;
+	uint64_t sample_ns;						// Duration of one conversion
+	bool raised;
+	bool start_event;						// Start of conversion from the event system
+} adc = { .last_refsel = 0xFF };
+
+static struct {
+	sim_sink sink;
+	void* context;
+	uint64_t tx_ready_ns;					// Transmitter free again
+	uint64_t rx_next_ns;					// Earliest time of the next received byte
+	bool rx_raised;
+	uint8_t rx_queue[RX_QUEUE_SIZE];
+	size_t rx_head;
+	size_t rx_tail;
+	bool stdin_open;
+	uint64_t stdin_next_ns;
+} usart;
+
+static struct {
+	twi_phase phase;						// Byte currently on the bus
+	uint64_t done_ns;
+	uint8_t address;						// Last address byte (with R/W Bit)
+	uint8_t data;
+	uint8_t status;							// MSTATUS as last written by the model
+	bool owner;								// A START was sent and no STOP yet
+	bool reading;
+} twi;
+
+static struct {
+	uint8_t pins;							// PCF8574 outputs
+	bool four_bit;
+	bool high_nibble;						// Next written nibble is the high one
+	uint8_t nibble;
+	bool read_high;							// Next read nibble is the high one
+	bool cgram;								// Data goes to CGRAM (not modelled)
+	uint8_t ddram[128];
+	uint8_t address;						// Address counter
+	bool increment;
+	bool display_on;
+	uint64_t busy_ns;
+	uint32_t violations;					// Accesses while busy
+	bool changed;
+	uint64_t changed_ns;
+	char printed[SIM_LCD_ROWS][SIM_LCD_COLUMNS + 1];
+} lcd;
+
+// PRIVATE FUNCTION DECLARATIONS //
+static void lock(void);
+static void unlock(void);
+static void api_begin(void);
+static void api_end(void);
+static void dispatch(void);
+static void on_signal(int signal);
+static void raise_irq(irq source);
+static bool is_pending(irq source);
+static uint16_t take(register16_t* reg);
+static uint8_t take8(register8_t* reg);
+static void* run(void* argument);
+static void step(void);
+static void port_step(void);
+static void rtc_step(void);
+static void pit_step(void);
+static void tca_step(void);
+static void event(uint8_t generator);
+static void adc_step(void);
+static void adc_begin(void);
+static void adc_finish(void);
+static double default_input(uint8_t muxpos, double seconds, void* context);
+static uint64_t usart_byte_ns(void);
+static void usart_step(void);
+static void stdout_sink(uint8_t byte, void* context);
+static void twi_step(void);
+static void twi_update(void);
+static void twi_begin(twi_phase phase, uint8_t data);
+static void twi_complete(void);
+static void pcf_write(uint8_t pins);
+static uint8_t pcf_read(void);
+static void lcd_execute(uint8_t value, bool rs);
+static void lcd_move(bool forward);
+static void lcd_step(void);
+static void eeprom_load(void);
+static void eeprom_save(void);
+static void finish_run(void);
+
+// PUBLIC FUNCTIONS //
+/*
+*	@return uint64_t Simulated time since the start in ns
+*/
+uint64_t sim_time_ns(void) {
+	return __atomic_load_n(&now_ns, __ATOMIC_ACQUIRE);
+}
+
+/*
+*	Replaces the signal at an ADC input.
+*	@param muxpos Input, e.g. ADC_MUXPOS_AIN19_gc
+*	@param waveform Function returning the voltage in mV at a time (NULL: default)
+*	@param context Passed to the waveform
+*	@return None
+*/
+void sim_adc_setInput(uint8_t muxpos, sim_waveform waveform, void* context) {
+
+	api_begin();
+	adc.waveform[muxpos & ADC_MUXPOS_gm] = (waveform != NULL) ? waveform : default_input;
+	adc.context[muxpos & ADC_MUXPOS_gm] = context;
+	api_end();
+}
+
+/*
+*	Replaces the receiver of the bytes sent by USART3 (default: stdout).
+*	@param sink Function called in the model thread for every byte (NULL: discard)
+*	@param context Passed to the sink
+*	@return None
+*/
+void sim_usart_setSink(sim_sink sink, void* context) {
+
+	api_begin();
+	usart.sink = sink;
+	usart.context = context;
+	api_end();
+}
+
+/*
+*	Queues bytes to be received by USART3 at its baud rate.
+*	@param data Bytes to be received
+*	@param length Number of bytes (excess beyond the queue is dropped)
+*	@return None
+*/
+void sim_usart_receive(const uint8_t* data, size_t length) {
+
+	api_begin();
+	for (size_t pos = 0; pos < length; pos++) {
+		size_t next = (usart.rx_head + 1) % RX_QUEUE_SIZE;
+		if (next == usart.rx_tail)
+			break;
+		usart.rx_queue[usart.rx_head] = data[pos];
+		usart.rx_head = next;
+	}
+	api_end();
+}
+
+/*
+*	Applies a level to a pin from outside (e.g. a button). Unconnected pins read high.
+*	@param port Port of the pin, e.g. &PORTC
+*	@param pin Pin number 0..7
+*	@param level true: high; false: low
+*	@return None
+*/
+void sim_port_setInput(PORT_t* port_reg, uint8_t pin, bool level) {
+
+	api_begin();
+	for (uint8_t index = 0; index < sizeof(ports) / sizeof(ports[0]); index++) {
+		if (ports[index] != port_reg)
+			continue;
+		if (level)
+			port.input[index] |= (uint8_t)(1 << pin);
+		else
+			port.input[index] &= (uint8_t)~(1 << pin);
+	}
+	api_end();
+}
+
+/*
+*	Reads one line of the simulated display as shown (blank if the display is off).
+*	@param row Line 0 or 1
+*	@param line Destination, SIM_LCD_COLUMNS + 1 bytes
+*	@return None
+*/
+void sim_lcd_getLine(uint8_t row, char* line) {
+
+	api_begin();
+	for (uint8_t column = 0; column < SIM_LCD_COLUMNS; column++) {
+		char character = (char)lcd.ddram[(row ? 0x40 : 0x00) + column];
+		line[column] = (lcd.display_on && character >= ' ' && character < 0x7F) ? character : ' ';
+	}
+	line[SIM_LCD_COLUMNS] = '\0';
+	api_end();
+}
+
+/*
+*	@return uint32_t Number of instructions or data sent to the display while it was busy
+*/
+uint32_t sim_lcd_violations(void) {
+	return __atomic_load_n(&lcd.violations, __ATOMIC_ACQUIRE);
+}
+
+// Functions behind the replacement headers //
+void sim_sei(void) {
+	sim_sreg |= CPU_I_bm;
+	dispatch();
+}
+
+void sim_cli(void) {
+	sim_sreg &= (uint8_t)~CPU_I_bm;
+}
+
+void sim_atomic_restore(const uint8_t* sreg) {
+	sim_sreg = *sreg;
+	dispatch();
+}
+
+void sim_atomic_forceOn(const uint8_t* sreg) {
+	(void)sreg;
+	sim_sei();
+}
+
+void sim_sleepEnable(void) {
+	SLPCTRL.CTRLA |= SLPCTRL_SEN_bm;
+	sleep_start = isr_count;
+}
+
+void sim_sleep(void) {
+
+	if (!(SLPCTRL.CTRLA & SLPCTRL_SEN_bm))
+		return;
+	while (isr_count == sleep_start)
+		sched_yield();		// Interrupts are dispatched by the signal handler meanwhile
+}
+
+void eeprom_read_block(void* destination, const void* source, size_t length) {
+	memcpy(destination, source, length);
+}
+
+void eeprom_write_block(const void* source, void* destination, size_t length) {
+	memcpy(destination, source, length);
+	eeprom_save();
+}
+
+void eeprom_update_block(const void* source, void* destination, size_t length) {
+	if (memcmp(destination, source, length) != 0)
+		eeprom_write_block(source, destination, length);
+}
+
+uint8_t eeprom_read_byte(const uint8_t* address) {
+	return *address;
+}
+
+void eeprom_write_byte(uint8_t* address, uint8_t value) {
+	eeprom_write_block(&value, address, 1);
+}
+
+void eeprom_update_byte(uint8_t* address, uint8_t value) {
+	eeprom_update_block(&value, address, 1);
+}
+
+void sim_delay_ns(double ns) {
+
+	uint64_t until = sim_time_ns() + (uint64_t)ns;
+	while (sim_time_ns() < until)
+		sched_yield();
+}
+
+// PRIVATE FUNCTIONS //
+// Fair spin lock: safe to take from the signal handler, which never interrupts a holder on its own thread //
+static void lock(void) {
+
+	uint32_t ticket = __atomic_fetch_add(&lock_next, 1, __ATOMIC_RELAXED);
+	while (__atomic_load_n(&lock_serving, __ATOMIC_ACQUIRE) != ticket)
+		sched_yield();
+}
+
+static void unlock(void) {
+	__atomic_fetch_add(&lock_serving, 1, __ATOMIC_RELEASE);
+}
+
+static void api_begin(void) {
+	in_api = true;
+	lock();
+}
+
+static void api_end(void) {
+	unlock();
+	in_api = false;
+	if (pthread_equal(pthread_self(), firmware_thread))
+		dispatch();		// Interrupts that were held back during the call
+}
+
+// Runs pending ISRs on the firmware thread while the I-Bit is set //
+static void dispatch(void) {
+
+	if (in_api || !pthread_equal(pthread_self(), firmware_thread))
+		return;
+
+	while (sim_sreg & CPU_I_bm) {
+		uint32_t waiting = __atomic_load_n(&pending, __ATOMIC_ACQUIRE);
+		if (waiting == 0)
+			break;
+
+		irq source = (irq)__builtin_ctz(waiting);
+
+		sim_sreg &= (uint8_t)~CPU_I_bm;		// Like the device: no nesting
+		lock();
+		if (vectors[source] != NULL)
+			vectors[source]();
+		__atomic_fetch_and(&pending, ~(1U << source), __ATOMIC_RELEASE);
+		isr_count++;
+		unlock();
+		sim_sreg |= CPU_I_bm;
+	}
+}
+
+static void on_signal(int signal) {
+
+	(void)signal;
+	int saved = errno;
+	dispatch();
+	errno = saved;
+}
+
+static void raise_irq(irq source) {
+
+	uint32_t before = __atomic_fetch_or(&pending, 1U << source, __ATOMIC_ACQ_REL);
+	if (!(before & (1U << source)))
+		pthread_kill(firmware_thread, SIGUSR1);
+}
+
+static bool is_pending(irq source) {
+	return __atomic_load_n(&pending, __ATOMIC_ACQUIRE) & (1U << source);
+}
+
+// Fetches a write-detecting register and re-arms it //
+static uint16_t take(register16_t* reg) {
+	return __atomic_exchange_n((uint16_t*)reg, SIM_UNWRITTEN, __ATOMIC_ACQ_REL);
+}
+
+// Fetches and clears a strobe register (DIRSET, OUTCLR, ...) //
+static uint8_t take8(register8_t* reg) {
+	return __atomic_exchange_n((uint8_t*)reg, 0, __ATOMIC_ACQ_REL);
+}
+
+/*
+*	Sets up the models before main() of the firmware and starts the model thread.
+*/
+__attribute__((constructor)) static void sim_start(void) {
+
+	firmware_thread = pthread_self();
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = on_signal;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGUSR1, &action, NULL);
+
+	for (uint8_t index = 0; index < sizeof(ports) / sizeof(ports[0]); index++) {
+		port.input[index] = 0xFF;
+		port.previous[index] = 0xFF;
+	}
+	for (uint16_t muxpos = 0; muxpos < 128; muxpos++)
+		adc.waveform[muxpos] = default_input;
+
+	usart.sink = stdout_sink;
+	usart.stdin_open = true;
+
+	lcd.increment = true;
+	memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+
+	eeprom_load();
+
+	const char* value = getenv("SIM_REALTIME");
+	realtime = (value != NULL && atoi(value) != 0);
+	value = getenv("SIM_TIME_LIMIT_MS");
+	if (value != NULL)
+		time_limit_ns = strtoull(value, NULL, 10) * 1000000ULL;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+	// Only the firmware thread takes the interrupt signal //
+	sigset_t mask, previous;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &mask, &previous);
+	pthread_create(&model_thread, NULL, run, NULL);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+}
+
+// Model thread //
+static void* run(void* argument) {
+
+	(void)argument;
+
+	while (1) {
+		lock();
+		step();
+		unlock();
+
+		// Like on the device, a pending interrupt is taken before the clock goes on //
+		while (__atomic_load_n(&pending, __ATOMIC_ACQUIRE) && (sim_sreg & CPU_I_bm))
+			sched_yield();
+
+		uint64_t now = __atomic_add_fetch(&now_ns, SIM_STEP_NS, __ATOMIC_ACQ_REL);
+
+		if (time_limit_ns != 0 && now >= time_limit_ns)
+			finish_run();
+
+		if (realtime && now % 1000000ULL == 0) {
+			struct timespec wall;
+			clock_gettime(CLOCK_MONOTONIC, &wall);
+			uint64_t elapsed = (uint64_t)(wall.tv_sec - start_time.tv_sec) * 1000000000ULL
+				+ (uint64_t)wall.tv_nsec - (uint64_t)start_time.tv_nsec;
+			if (now > elapsed) {
+				struct timespec pause = { .tv_sec = (time_t)((now - elapsed) / 1000000000ULL),
+										  .tv_nsec = (long)((now - elapsed) % 1000000000ULL) };
+				nanosleep(&pause, NULL);
+			}
+		}
+	}
+	return NULL;
+}
+
+static void step(void) {
+	port_step();
+	rtc_step();
+	pit_step();
+	tca_step();
+	adc_step();
+	usart_step();
+	twi_step();
+	lcd_step();
+}
+
+// PORT: strobe registers, input levels and pin change interrupts //
+static void port_step(void) {
+
+	for (uint8_t index = 0; index < sizeof(ports) / sizeof(ports[0]); index++) {
+		PORT_t* reg = ports[index];
+
+		reg->DIR |= take8(&reg->DIRSET);
+		reg->DIR &= (uint8_t)~take8(&reg->DIRCLR);
+		reg->DIR ^= take8(&reg->DIRTGL);
+		reg->OUT |= take8(&reg->OUTSET);
+		reg->OUT &= (uint8_t)~take8(&reg->OUTCLR);
+		reg->OUT ^= take8(&reg->OUTTGL);
+
+		// INTFLAGS is write-1-to-clear: a store outside the ISR must not set flags //
+		if (reg->INTFLAGS != port.flags[index])
+			port.flags[index] &= (uint8_t)~reg->INTFLAGS;
+
+		// The ISR has returned: it cleared the flags it has seen //
+		if (port.raised[index] && !is_pending((irq)(IRQ_PORTA + index))) {
+			port.flags[index] = 0;
+			port.raised[index] = false;
+		}
+
+		uint8_t in = (uint8_t)((reg->OUT & reg->DIR) | (port.input[index] & ~reg->DIR));
+		uint8_t previous = port.previous[index];
+		uint8_t flags = 0;
+
+		for (uint8_t pin = 0; pin < 8; pin++) {
+			uint8_t control = (&reg->PIN0CTRL)[pin];
+			uint8_t mask = (uint8_t)(1 << pin);
+
+			if (control & PORT_INVEN_bm)
+				in ^= mask;
+
+			switch (control & PORT_ISC_gm) {
+				case PORT_ISC_BOTHEDGES_gc:
+					if ((in ^ previous) & mask)
+						flags |= mask;
+					break;
+				case PORT_ISC_RISING_gc:
+					if ((in & mask) && !(previous & mask))
+						flags |= mask;
+					break;
+				case PORT_ISC_FALLING_gc:
+					if (!(in & mask) && (previous & mask))
+						flags |= mask;
+					break;
+				case PORT_ISC_LEVEL_gc:
+					if (!(in & mask))
+						flags |= mask;
+					break;
+				default:
+					break;
+			}
+		}
+
+		port.previous[index] = in;
+		reg->IN = in;
+
+		port.flags[index] |= flags;
+		reg->INTFLAGS = port.flags[index];
+		if (flags != 0) {
+			if (!port.raised[index]) {
+				port.raised[index] = true;
+				raise_irq((irq)(IRQ_PORTA + index));
+			}
+		}
+	}
+}
+
+// RTC: counts the 32.768kHz oscillator //
+static void rtc_step(void) {
+
+	if (rtc.raised && !is_pending(IRQ_RTC_CNT)) {
+		RTC.INTFLAGS = 0;
+		rtc.raised = false;
+	}
+	if (!(RTC.CTRLA & RTC_RTCEN_bm))
+		return;
+
+	uint64_t tick = 1000000000ULL << ((RTC.CTRLA & RTC_PRESCALER_gm) >> 3);		// ns * 32768 per count
+	rtc.accumulator += (uint64_t)SIM_STEP_NS * 32768ULL;
+
+	while (rtc.accumulator >= tick) {
+		rtc.accumulator -= tick;
+		if (RTC.CNT == RTC.PER) {
+			RTC.CNT = 0;
+			RTC.INTFLAGS |= RTC_OVF_bm;
+			if ((RTC.INTCTRL & RTC_OVF_bm) && !rtc.raised) {
+				rtc.raised = true;
+				raise_irq(IRQ_RTC_CNT);
+			}
+		}
+		else {
+			RTC.CNT++;
+		}
+	}
+}
+
+// RTC PIT: periodic interrupt every 4..32768 oscillator cycles, independent of RTCEN //
+static void pit_step(void) {
+
+	if (pit.raised && !is_pending(IRQ_RTC_PIT)) {
+		RTC.PITINTFLAGS = 0;
+		pit.raised = false;
+	}
+	uint8_t period = (RTC.PITCTRLA & RTC_PERIOD_gm) >> 3;
+	if (!(RTC.PITCTRLA & RTC_PITEN_bm) || period == 0 || period > 15) {
+		pit.accumulator = 0;
+		return;
+	}
+
+	uint64_t tick = (1000000000ULL * 4) << (period - 1);		// ns * 32768 per period
+	pit.accumulator += (uint64_t)SIM_STEP_NS * 32768ULL;
+
+	while (pit.accumulator >= tick) {
+		pit.accumulator -= tick;
+		RTC.PITINTFLAGS |= RTC_PI_bm;
+		if ((RTC.PITINTCTRL & RTC_PI_bm) && !pit.raised) {
+			pit.raised = true;
+			raise_irq(IRQ_RTC_PIT);
+		}
+	}
+}
+
+// TCA0 / TCA1 in single slope / normal mode: count up to PER, the overflow is an event generator //
+static void tca_step(void) {
+
+	static const uint16_t divider[] = { 1, 2, 4, 8, 16, 64, 256, 1024 };
+
+	for (uint8_t index = 0; index < sizeof(timers) / sizeof(timers[0]); index++) {
+		TCA_SINGLE_t* reg = &timers[index]->SINGLE;
+
+		if (tca[index].raised && !is_pending(IRQ_TCA0_OVF)) {
+			reg->INTFLAGS &= (uint8_t)~TCA_SINGLE_OVF_bm;
+			tca[index].raised = false;
+		}
+		if (!(reg->CTRLA & TCA_SINGLE_ENABLE_bm))
+			continue;
+
+		uint64_t tick = 1000000000ULL * divider[(reg->CTRLA & TCA_SINGLE_CLKSEL_gm) >> 1];	// ns * F_CPU per count
+		tca[index].accumulator += (uint64_t)SIM_STEP_NS * SIM_F_CPU;
+
+		while (tca[index].accumulator >= tick) {
+			tca[index].accumulator -= tick;
+			if (reg->CNT < reg->PER) {
+				reg->CNT++;
+				continue;
+			}
+
+			reg->CNT = 0;
+			reg->INTFLAGS |= TCA_SINGLE_OVF_bm;
+			event((uint8_t)(EVSYS_CHANNEL0_TCA0_OVF_LUNF_gc + 8 * index));
+
+			// Only the overflow interrupt of TCA0 is modelled //
+			if (index == 0 && (reg->INTCTRL & TCA_SINGLE_OVF_bm) && !tca[index].raised) {
+				tca[index].raised = true;
+				raise_irq(IRQ_TCA0_OVF);
+			}
+		}
+	}
+}
+
+// EVSYS: passes a generator to the users of every channel it is routed to //
+static void event(uint8_t generator) {
+
+	register8_t* channels = &EVSYS.CHANNEL0;
+
+	for (uint8_t channel = 0; channel < 10; channel++) {
+		if (channels[channel] != generator)
+			continue;
+		if (EVSYS.USERADC0START == channel + 1)
+			adc.start_event = true;
+
+		// TCB0 counting events (periodic interrupt mode, no interrupt modelled) //
+		if (EVSYS.USERTCB0COUNT == channel + 1 && (TCB0.CTRLA & TCB_ENABLE_bm)
+			&& (TCB0.CTRLA & TCB_CLKSEL_gm) == TCB_CLKSEL_EVENT_gc)
+			TCB0.CNT = (TCB0.CNT == TCB0.CCMP) ? 0 : TCB0.CNT + 1;
+	}
+}
+
+// ADC0: single and free-running conversions with accumulation //
+static void adc_step(void) {
+
+	if (adc.raised && !is_pending(IRQ_ADC0_RESRDY)) {
+		ADC0.INTFLAGS &= (uint8_t)~ADC_RESRDY_bm;		// The ISR has read RES
+		adc.raised = false;
+	}
+	if (!(ADC0.CTRLA & ADC_ENABLE_bm)) {
+		adc.converting = false;
+		adc.start_event = false;
+		return;
+	}
+
+	uint64_t now = now_ns;
+	if (adc.converting && now >= adc.done_ns) {
+		adc_finish();
+		if (ADC0.CTRLA & ADC_FREERUN_bm)
+			adc_begin();
+	}
+	if (!adc.converting && (ADC0.COMMAND & ADC_STCONV_bm)) {
+		__atomic_fetch_and((uint8_t*)&ADC0.COMMAND, (uint8_t)~ADC_STCONV_bm, __ATOMIC_ACQ_REL);
+		adc_begin();
+	}
+	if (adc.start_event) {
+		adc.start_event = false;		// Ignored while a conversion is running
+		if (!adc.converting && (ADC0.EVCTRL & ADC_STARTEI_bm))
+			adc_begin();
+	}
+}
+
+static void adc_begin(void) {
+
+	static const uint8_t prescaler[] = { 2, 4, 6, 8, 10, 12, 14, 16, 20, 24, 28, 32, 40, 48, 56, 64 };
+
+	adc.muxpos = ADC0.MUXPOS & ADC_MUXPOS_gm;
+	adc.refsel = VREF.ADC0REF & VREF_REFSEL_gm;
+	adc.sampnum = ADC0.CTRLB & ADC_SAMPNUM_gm;
+
+	// Sampling (SAMPCTRL + 2) and 13 conversion cycles of CLK_ADC per result //
+	uint64_t clock_ns = 1000000000ULL * prescaler[ADC0.CTRLC & ADC_PRESC_gm] / SIM_F_CPU;
+	adc.sample_ns = (ADC0.SAMPCTRL + 2ULL + 13ULL) * clock_ns;
+
+	uint64_t delay_ns = 0;
+	uint8_t initdly = (ADC0.CTRLD & ADC_INITDLY_gm) >> 5;
+	if (adc.refsel != adc.last_refsel && initdly != 0)
+		delay_ns = (16ULL << (initdly - 1)) * clock_ns;		// Reference settles after a change
+	adc.last_refsel = adc.refsel;
+
+	adc.start_ns = now_ns + delay_ns;
+	adc.done_ns = adc.start_ns + adc.sample_ns * (1ULL << adc.sampnum);
+	adc.converting = true;
+}
+
+static void adc_finish(void) {
+
+	static const double reference_mv[] = { 1024, 2048, 4096, 2500, SIM_VDD_MV, SIM_VDD_MV, SIM_VDD_MV, SIM_VDD_MV };
+	double reference = reference_mv[adc.refsel];
+	uint32_t sum = 0;
+
+	for (uint32_t sample = 0; sample < (1U << adc.sampnum); sample++) {
+		double seconds = (double)(adc.start_ns + adc.sample_ns * (sample + 1)) / 1e9;
+		double mv = adc.waveform[adc.muxpos](adc.muxpos, seconds, adc.context[adc.muxpos]);
+		long code = lround(mv * 4096.0 / reference);
+
+		if (code < 0)
+			code = 0;
+		if (code > 4095)
+			code = 4095;
+		if ((ADC0.CTRLA & ADC_RESSEL_gm) == ADC_RESSEL_10BIT_gc)
+			code >>= 2;
+		sum += (uint32_t)code;
+	}
+	if (adc.sampnum > 4)
+		sum >>= adc.sampnum - 4;		// Sums of more than 16 results are truncated to 16 Bit
+
+	ADC0.RES = (uint16_t)sum;
+	ADC0.INTFLAGS |= ADC_RESRDY_bm;
+	adc.converting = false;
+
+	if ((ADC0.INTCTRL & ADC_RESRDY_bm) && !adc.raised) {
+		adc.raised = true;
+		raise_irq(IRQ_ADC0_RESRDY);
+	}
+}
+
+// Triangle 0..VDD with 10s period on every input; 25 degC at the temperature sensor //
+static double default_input(uint8_t muxpos, double seconds, void* context) {
+
+	(void)context;
+
+	if (muxpos == ADC_MUXPOS_TEMPSENSE_gc) {
+		double raw = SIGROW.TEMPSENSE1 - 298.15 * 4096.0 / SIGROW.TEMPSENSE0;	// T[K] = (TEMPSENSE1 - RES) * TEMPSENSE0 / 4096
+		return raw * 2048.0 / 4096.0;
+	}
+	if (muxpos == ADC_MUXPOS_GND_gc)
+		return 0.0;
+
+	double phase = fmod(seconds / 10.0, 1.0);
+	return SIM_VDD_MV * (phase < 0.5 ? 2.0 * phase : 2.0 - 2.0 * phase);
+}
+
+// USART3: one frame (start, 8 data, stop) takes 10 Bit times //
+static uint64_t usart_byte_ns(void) {
+
+	uint16_t baud = USART3.BAUD;
+	uint8_t samples = ((USART3.CTRLB & USART_RXMODE_gm) == USART_RXMODE_CLK2X_gc) ? 8 : 16;
+
+	if (baud < 64)
+		return 0;		// Not configured
+	return (uint64_t)(10.0 * 1e9 * samples * baud / (64.0 * SIM_F_CPU));
+}
+
+static void usart_step(void) {
+
+	uint64_t now = now_ns;
+	uint64_t byte_ns = usart_byte_ns();
+
+	// Transmitter: data register empty interrupt while the last byte is shifted out //
+	if (!is_pending(IRQ_USART3_DRE)) {
+		uint16_t data = take(&USART3.TXDATAL);
+
+		if (data < 0x100 && (USART3.CTRLB & USART_TXEN_bm) && byte_ns != 0) {
+			if (usart.sink != NULL)
+				usart.sink((uint8_t)data, usart.context);
+			if (USART3.CTRLA & USART_LBME_bm) {
+				size_t next = (usart.rx_head + 1) % RX_QUEUE_SIZE;		// Loop-back: TXD also drives RXD
+				if (next != usart.rx_tail) {
+					usart.rx_queue[usart.rx_head] = (uint8_t)data;
+					usart.rx_head = next;
+				}
+			}
+			usart.tx_ready_ns = now + byte_ns;
+		}
+
+		if (now >= usart.tx_ready_ns)
+			USART3.STATUS |= USART_DREIF_bm | USART_TXCIF_bm;
+		else
+			USART3.STATUS &= (uint8_t)~(USART_DREIF_bm | USART_TXCIF_bm);
+
+		if ((USART3.CTRLB & USART_TXEN_bm) && (USART3.CTRLA & USART_DREIE_bm) && now >= usart.tx_ready_ns)
+			raise_irq(IRQ_USART3_DRE);
+	}
+
+	// Receiver //
+	if (usart.stdin_open && now >= usart.stdin_next_ns) {
+		usart.stdin_next_ns = now + STDIN_POLL_NS;
+
+		struct pollfd input = { .fd = STDIN_FILENO, .events = POLLIN };
+		size_t next = (usart.rx_head + 1) % RX_QUEUE_SIZE;
+		if (next != usart.rx_tail && poll(&input, 1, 0) > 0) {
+			uint8_t byte;
+			if (read(STDIN_FILENO, &byte, 1) == 1) {
+				usart.rx_queue[usart.rx_head] = byte;
+				usart.rx_head = next;
+			}
+			else {
+				usart.stdin_open = false;		// End of input
+			}
+		}
+	}
+
+	if (usart.rx_raised && !is_pending(IRQ_USART3_RXC)) {
+		USART3.STATUS &= (uint8_t)~USART_RXCIF_bm;		// The ISR has read RXDATAL
+		usart.rx_raised = false;
+	}
+
+	if (!usart.rx_raised && (USART3.CTRLB & USART_RXEN_bm) && byte_ns != 0
+		&& now >= usart.rx_next_ns && usart.rx_tail != usart.rx_head) {
+		USART3.RXDATAL = usart.rx_queue[usart.rx_tail];
+		usart.rx_tail = (usart.rx_tail + 1) % RX_QUEUE_SIZE;
+		USART3.STATUS |= USART_RXCIF_bm;
+		usart.rx_next_ns = now + byte_ns;
+
+		if (USART3.CTRLA & USART_RXCIE_bm) {
+			usart.rx_raised = true;
+			raise_irq(IRQ_USART3_RXC);
+		}
+	}
+}
+
+static void stdout_sink(uint8_t byte, void* context) {
+
+	(void)context;
+	if (write(STDOUT_FILENO, &byte, 1) != 1)
+		usart.sink = NULL;
+}
+
+// TWI0 master with a PCF8574 at SIM_LCD_ADDRESS; every byte takes 9 SCL periods //
+static void twi_step(void) {
+
+	// MSTATUS differs from the last model value: the firmware wrote ones to clear flags //
+	uint8_t written = TWI0.MSTATUS;
+	if (written != twi.status) {
+		uint8_t status = twi.status & (uint8_t)~(written & TWI_STATUS_FLAGS);
+		if ((written ^ twi.status) & TWI_BUSSTATE_gm)
+			status = (uint8_t)((status & ~TWI_BUSSTATE_gm) | (written & TWI_BUSSTATE_gm));
+		TWI0.MSTATUS = status;
+	}
+
+	twi_update();
+	twi.status = TWI0.MSTATUS;
+}
+
+static void twi_update(void) {
+
+	if (!(TWI0.MCTRLA & TWI_ENABLE_bm))
+		return;
+
+	if (twi.phase != TWI_NONE) {
+		if (now_ns < twi.done_ns)
+			return;
+		twi_complete();
+	}
+
+	// The firmware writes MCTRLB (STOP) before MADDR (next START): fetch in reverse order //
+	uint16_t address = take(&TWI0.MADDR);
+	uint16_t command = take(&TWI0.MCTRLB);
+	uint16_t data = twi.reading ? SIM_UNWRITTEN : take(&TWI0.MDATA);
+
+	if (command < 0x100) {
+		TWI0.MSTATUS &= (uint8_t)~(TWI_RIF_bm | TWI_WIF_bm);
+
+		switch (command & TWI_MCMD_gm) {
+			case TWI_MCMD_STOP_gc:
+				twi.owner = false;
+				twi.reading = false;
+				TWI0.MSTATUS = (uint8_t)((TWI0.MSTATUS & ~TWI_BUSSTATE_gm) | TWI_BUSSTATE_IDLE_gc);
+				break;
+			case TWI_MCMD_RECVTRANS_gc:
+				if (twi.owner && twi.reading)
+					twi_begin(TWI_READ, 0);
+				break;
+			case TWI_MCMD_REPSTART_gc:
+				if (twi.owner)
+					twi_begin(TWI_ADDRESS, twi.address);
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (address < 0x100) {
+		TWI0.MSTATUS &= (uint8_t)~(TWI_RIF_bm | TWI_WIF_bm | TWI_RXACK_bm);
+		TWI0.MSTATUS = (uint8_t)((TWI0.MSTATUS & ~TWI_BUSSTATE_gm) | TWI_BUSSTATE_OWNER_gc);
+		twi.owner = true;
+		twi.address = (uint8_t)address;
+		twi.reading = (address & 1) != 0;
+		if (!twi.reading)
+			TWI0.MDATA = SIM_UNWRITTEN;
+		twi_begin(TWI_ADDRESS, (uint8_t)address);
+	}
+	else if (data < 0x100 && twi.owner) {
+		TWI0.MSTATUS &= (uint8_t)~(TWI_RIF_bm | TWI_WIF_bm);
+		twi_begin(TWI_WRITE, (uint8_t)data);
+	}
+}
+
+static void twi_begin(twi_phase phase, uint8_t data) {
+
+	uint64_t scl_hz = SIM_F_CPU / (10ULL + 2ULL * TWI0.MBAUD);
+
+	twi.phase = phase;
+	twi.data = data;
+	twi.done_ns = now_ns + 9ULL * 1000000000ULL / scl_hz;
+}
+
+static void twi_complete(void) {
+
+	bool present = (twi.address >> 1) == SIM_LCD_ADDRESS;
+	uint8_t status = TWI0.MSTATUS & (uint8_t)~(TWI_RIF_bm | TWI_WIF_bm | TWI_RXACK_bm);
+
+	switch (twi.phase) {
+		case TWI_ADDRESS:
+			if (!present)
+				status |= TWI_WIF_bm | TWI_RXACK_bm;		// NACK
+			else if (twi.reading) {
+				TWI0.MDATA = pcf_read();					// First byte follows the address
+				status |= TWI_RIF_bm;
+			}
+			else
+				status |= TWI_WIF_bm;
+			break;
+		case TWI_WRITE:
+			if (present)
+				pcf_write(twi.data);
+			status |= TWI_WIF_bm;
+			break;
+		case TWI_READ:
+			TWI0.MDATA = pcf_read();
+			status |= TWI_RIF_bm;
+			break;
+		default:
+			break;
+	}
+
+	twi.phase = TWI_NONE;
+	TWI0.MSTATUS = status;
+
+	if (((status & TWI_RIF_bm) && (TWI0.MCTRLA & TWI_RIEN_bm)) || ((status & TWI_WIF_bm) && (TWI0.MCTRLA & TWI_WIEN_bm)))
+		raise_irq(IRQ_TWI0_TWIM);
+}
+
+// PCF8574 outputs drive RS, RW, E and D7..D4 of the HD44780 //
+static void pcf_write(uint8_t pins) {
+
+	uint8_t previous = lcd.pins;
+	lcd.pins = pins;
+
+	if (!(previous & LCD_E) || (pins & LCD_E))
+		return;		// Only the falling edge of E completes a cycle
+
+	if (pins & LCD_RW) {
+		lcd.read_high = !lcd.read_high || !lcd.four_bit;
+		return;
+	}
+
+	uint8_t nibble = pins >> 4;
+	lcd.read_high = true;
+
+	if (!lcd.four_bit) {
+		lcd_execute((uint8_t)(nibble << 4), pins & LCD_RS);		// D3..D0 are not connected
+	}
+	else if (lcd.high_nibble) {
+		lcd.nibble = nibble;
+		lcd.high_nibble = false;
+	}
+	else {
+		lcd.high_nibble = true;
+		lcd_execute((uint8_t)((lcd.nibble << 4) | nibble), pins & LCD_RS);
+	}
+}
+
+// Quasi-bidirectional pins: the display can pull D7..D4 low while RW and E are high //
+static uint8_t pcf_read(void) {
+
+	uint8_t pins = lcd.pins;
+
+	if ((pins & LCD_RW) && (pins & LCD_E) && !(pins & LCD_RS)) {
+		uint8_t value = (uint8_t)((now_ns < lcd.busy_ns ? 0x80 : 0x00) | (lcd.address & 0x7F));
+		uint8_t nibble = lcd.read_high ? (value >> 4) : (value & 0x0F);
+		pins = (uint8_t)((pins & 0x0F) | (pins & (nibble << 4)));
+	}
+	return pins;
+}
+
+static void lcd_execute(uint8_t value, bool rs) {
+
+	uint64_t now = now_ns;
+	uint64_t duration = LCD_EXEC_NS;
+
+	if (now < lcd.busy_ns)
+		__atomic_add_fetch(&lcd.violations, 1, __ATOMIC_RELEASE);
+
+	if (rs) {
+		if (!lcd.cgram) {
+			lcd.ddram[lcd.address & 0x7F] = value;
+			lcd_move(lcd.increment);
+		}
+		duration = LCD_DATA_NS;
+	}
+	else if (value & 0x80) {			// Set DDRAM address
+		lcd.address = value & 0x7F;
+		lcd.cgram = false;
+	}
+	else if (value & 0x40) {			// Set CGRAM address
+		lcd.cgram = true;
+	}
+	else if (value & 0x20) {			// Function set
+		bool four_bit = !(value & 0x10);
+		if (four_bit && !lcd.four_bit)
+			lcd.high_nibble = true;
+		lcd.four_bit = four_bit;
+	}
+	else if (value & 0x10) {			// Cursor / display shift
+		if (!(value & 0x08))
+			lcd_move(value & 0x04);
+	}
+	else if (value & 0x08) {			// Display on / off
+		lcd.display_on = value & 0x04;
+	}
+	else if (value & 0x04) {			// Entry mode
+		lcd.increment = value & 0x02;
+	}
+	else if (value & 0x02) {			// Return home
+		lcd.address = 0;
+		duration = LCD_CLEAR_NS;
+	}
+	else if (value & 0x01) {			// Clear display
+		memset(lcd.ddram, ' ', sizeof(lcd.ddram));
+		lcd.address = 0;
+		lcd.increment = true;
+		duration = LCD_CLEAR_NS;
+	}
+
+	lcd.busy_ns = now + duration;
+	lcd.changed = true;
+	lcd.changed_ns = now;
+}
+
+// Address counter in 2-line mode: 0x00..0x27 and 0x40..0x67 //
+static void lcd_move(bool forward) {
+
+	uint8_t address = lcd.address;
+
+	if (forward)
+		address = (address == 0x27) ? 0x40 : (address == 0x67) ? 0x00 : (uint8_t)(address + 1);
+	else
+		address = (address == 0x00) ? 0x67 : (address == 0x40) ? 0x27 : (uint8_t)(address - 1);
+	lcd.address = address;
+}
+
+// Prints the display to stderr once it has settled after a change //
+static void lcd_step(void) {
+
+	if (!lcd.changed || now_ns - lcd.changed_ns < LCD_SETTLE_NS)
+		return;
+	lcd.changed = false;
+
+	bool differs = false;
+	char lines[SIM_LCD_ROWS][SIM_LCD_COLUMNS + 1];
+
+	for (uint8_t row = 0; row < SIM_LCD_ROWS; row++) {
+		for (uint8_t column = 0; column < SIM_LCD_COLUMNS; column++) {
+			char character = (char)lcd.ddram[(row ? 0x40 : 0x00) + column];
+			lines[row][column] = (lcd.display_on && character >= ' ' && character < 0x7F) ? character : ' ';
+		}
+		lines[row][SIM_LCD_COLUMNS] = '\0';
+		if (strcmp(lines[row], lcd.printed[row]) != 0)
+			differs = true;
+	}
+	if (!differs)
+		return;
+
+	memcpy(lcd.printed, lines, sizeof(lines));
+	fprintf(stderr, "[%8.3f s] LCD |%s|%s|\n", (double)now_ns / 1e9, lines[0], lines[1]);
+}
+
+// EEPROM: erased, then the content of SIM_EEPROM if the file exists //
+static void eeprom_load(void) {
+
+	if (__start_sim_eeprom == NULL)
+		return;
+	memset(__start_sim_eeprom, 0xFF, (size_t)(__stop_sim_eeprom - __start_sim_eeprom));
+
+	eeprom_file = getenv("SIM_EEPROM");
+	if (eeprom_file == NULL)
+		return;
+	FILE* file = fopen(eeprom_file, "rb");
+	if (file != NULL) {
+		size_t length = fread(__start_sim_eeprom, 1, (size_t)(__stop_sim_eeprom - __start_sim_eeprom), file);
+		(void)length;		// A shorter file leaves the rest erased
+		fclose(file);
+	}
+}
+
+static void eeprom_save(void) {
+
+	if (eeprom_file == NULL)
+		return;
+	FILE* file = fopen(eeprom_file, "wb");
+	if (file == NULL)
+		return;
+	fwrite(__start_sim_eeprom, 1, (size_t)(__stop_sim_eeprom - __start_sim_eeprom), file);
+	fclose(file);
+}
+
+static void finish_run(void) {
+
+	fprintf(stderr, "[%8.3f s] end of simulation, %u display access(es) while busy\n",
+		(double)now_ns / 1e9, (unsigned)lcd.violations);
+	fflush(stdout);
+	fflush(stderr);
+	_exit(0);
+}
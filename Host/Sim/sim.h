@@ -0,0 +1,89 @@
+/*
+ ***********************************************************************************
+ * @file:   sim.h
+ * @date:   17.10.2026
+ *
+ * Host simulation of the AVR128DB48 peripherals used by this project, so the
+ * firmware (main1.c .. main5.c and Include/) builds and runs on Linux.
+ *
+ * A model thread advances a simulated clock in steps of SIM_STEP_NS and emulates
+ * ADC0, USART3, TWI0 with a PCF8574 + HD44780 display, TCA0/TCA1, TCB0 (event counter), EVSYS, the RTC (counter and PIT) and the ports.
+ * Interrupts are delivered to the firmware thread by a signal and call the ISR()
+ * functions there, so they preempt the main program like on the device. While an
+ * ISR runs, the models are halted.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Build from the repository root with the headers of Host/Sim in front, e.g.
+      gcc -IHost/Sim -IInclude/USART -IInclude/Format -IInclude/Parse -IInclude/Power -IInclude/RTC \
+          main5.c Include/USART/USART.c Include/Format/Format.c Include/Parse/Parse.c \
+          Include/Power/Power.c Include/RTC/RTC.c Host/Sim/sim.c -lpthread -lm -o main5
+  (main1.c / main2.c additionally need ADC, AVR128DB48_I2C, I2C_LCD and Convert).
+
+  The simulation starts by itself before main(). Without further setup:
+  - USART3 output goes to stdout, input is read from stdin. With USART_LBME_bm set (loop-back)
+    the sent bytes are received as well.
+  - Analog inputs AINx follow a triangle from 0 to VDD with a period of 10s,
+    the temperature sensor reads 25 degC with the SIGROW values below.
+  - The display is printed to stderr whenever its content changed.
+  Environment: SIM_REALTIME=1 locks the simulated clock to the wall clock,
+  SIM_TIME_LIMIT_MS=n ends the program after n ms of simulated time,
+  SIM_EEPROM=file keeps the EEMEM variables in a file across runs (avr/eeprom.h).
+
+  Limitations: the models are behavioral, not cycle accurate (time advances in
+  steps of SIM_STEP_NS, code runs in zero simulated time). Flags that an ISR clears
+  by writing a one or by reading a data register are cleared when the ISR returns.
+  Only the registers and interrupts used by this project exist.
+
+  A test program can replace these defaults with the functions below, e.g. from a
+  thread of its own while the firmware main() (renamed with -Dmain=firmware_main) runs.
+*/
+
+
+#ifndef SIM_H_
+#define SIM_H_
+
+// INCLUDES //
+#include <avr/io.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DEFINES //
+#ifndef SIM_F_CPU
+#define SIM_F_CPU			4000000UL	// Peripheral clock of the models
+#endif
+
+#define SIM_STEP_NS			1000		// Resolution of the simulated clock
+#define SIM_VDD_MV			3300		// Supply voltage, reference VDD
+
+#define SIM_LCD_ADDRESS		0x27		// I2C address of the PCF8574
+#define SIM_LCD_COLUMNS		16
+#define SIM_LCD_ROWS		2
+
+// TYPES //
+typedef double (*sim_waveform)(uint8_t muxpos, double seconds, void* context);	// Returns the input voltage in mV
+typedef void (*sim_sink)(uint8_t byte, void* context);
+
+// FUNCTION DECLARATIONS //
+uint64_t sim_time_ns(void);
+
+void sim_adc_setInput(uint8_t muxpos, sim_waveform waveform, void* context);
+
+void sim_usart_setSink(sim_sink sink, void* context);
+
+void sim_usart_receive(const uint8_t* data, size_t length);
+
+void sim_port_setInput(PORT_t* port, uint8_t pin, bool level);
+
+void sim_lcd_getLine(uint8_t row, char* line);
+
+uint32_t sim_lcd_violations(void);
+
+
+#endif /* SIM_H_ */
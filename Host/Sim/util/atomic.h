@@ -0,0 +1,42 @@
+/*
+ ***********************************************************************************
+ * @file:   util/atomic.h (host simulation)
+ * @date:   17.10.2026
+ *
+ * ATOMIC_BLOCK() with the same structure as avr-libc: the I-Bit is cleared on entry
+ * and restored by a cleanup handler, so leaving the block with return is allowed.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+
+#ifndef SIM_UTIL_ATOMIC_H_
+#define SIM_UTIL_ATOMIC_H_
+
+// INCLUDES //
+#include <avr/interrupt.h>
+
+// FUNCTION DECLARATIONS //
+void sim_atomic_restore(const uint8_t* sreg);
+
+void sim_atomic_forceOn(const uint8_t* sreg);
+
+// Inline like __iCliRetVal() of avr-libc, so the compiler knows the block runs once //
+static inline uint8_t sim_atomic_enter(void) {
+	cli();
+	return 1;
+}
+
+// DEFINES //
+#define ATOMIC_BLOCK(type)		for (type, sim_atomic_todo = sim_atomic_enter(); sim_atomic_todo; sim_atomic_todo = 0)
+
+#define ATOMIC_RESTORESTATE		uint8_t sim_atomic_sreg __attribute__((__cleanup__(sim_atomic_restore))) = SREG
+#define ATOMIC_FORCEON			uint8_t sim_atomic_sreg __attribute__((__cleanup__(sim_atomic_forceOn))) = 0
+
+
+#endif /* SIM_UTIL_ATOMIC_H_ */
@@ -0,0 +1,51 @@
+/*
+ ***********************************************************************************
+ * @file:   util/crc16.h (host simulation)
+ * @date:   17.10.2026
+ *
+ * Portable versions of the avr-libc CRC update functions.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+
+#ifndef SIM_UTIL_CRC16_H_
+#define SIM_UTIL_CRC16_H_
+
+// INCLUDES //
+#include <stdint.h>
+
+// Polynomial 0x1021, not reflected //
+static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data) {
+	
+	crc ^= (uint16_t)data << 8;
+	for (uint8_t bit = 0; bit < 8; bit++)
+		crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	return crc;
+}
+
+// Polynomial 0x8408 (0x1021 reflected) //
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data) {
+	
+	crc ^= data;
+	for (uint8_t bit = 0; bit < 8; bit++)
+		crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0x8408) : (uint16_t)(crc >> 1);
+	return crc;
+}
+
+// Polynomial 0xA001 (0x8005 reflected) //
+static inline uint16_t _crc16_update(uint16_t crc, uint8_t data) {
+	
+	crc ^= data;
+	for (uint8_t bit = 0; bit < 8; bit++)
+		crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+	return crc;
+}
+
+
+#endif /* SIM_UTIL_CRC16_H_ */
@@ -0,0 +1,29 @@
+/*
+ ***********************************************************************************
+ * @file:   util/delay.h (host simulation)
+ * @date:   17.10.2026
+ *
+ * Busy waits in simulated time: the functions return once the models have advanced
+ * by the requested time. Not allowed inside an ISR (the models are halted there).
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+// FUNCTION DECLARATIONS //
+void sim_delay_ns(double ns);
+
+// DEFINES //
+#define _delay_us(us)	sim_delay_ns((us) * 1000.0)
+#define _delay_ms(ms)	sim_delay_ns((ms) * 1000000.0)
+
+
+#endif /* SIM_UTIL_DELAY_H_ */
@@ -0,0 +1,346 @@
+/*
+ ***********************************************************************************
+ * @file:   telemetry_decoder.c
+ * @date:   17.10.2026
+ *
+ * Host-side decoder for the binary telemetry stream of Include/Telemetry.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "telemetry_decoder.h"
+
+// DEFINES //
+#define RECORD_SIZE		6		// type, timestamp, channel, value
+#define CRC_SIZE		2
+
+// PRIVATE FUNCTION DECLARATIONS //
+static int cobs_decode(const uint8_t* frame, unsigned length, uint8_t* data);
+static telemetry_decode_result decode_frame(telemetry_decoder* decoder);
+static bool decode_sample(telemetry_decoder* decoder, const uint8_t* payload, unsigned length);
+static bool decode_block(telemetry_decoder* decoder, const uint8_t* payload, unsigned length);
+static bool get_varint(const uint8_t* data, unsigned length, unsigned* pos, uint32_t* value);
+static void add_record(telemetry_decoder* decoder, uint16_t timestamp, uint8_t channel, uint16_t value);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Resets the decoder; an invalid first frame (stream joined in its middle) is ignored silently.
+*	@param decoder Decoder state
+*	@return None
+*/
+void telemetry_decoder_init(telemetry_decoder* decoder) {
+	
+	decoder->length = 0;
+	decoder->overflow = false;
+	decoder->synchronized = false;
+	decoder->ready_count = 0;
+	decoder->ready_read = 0;
+	decoder->time_valid = false;
+	decoder->ticks = 0;
+	decoder->block_valid = false;
+	decoder->next_sequence = 0;
+	decoder->records = 0;
+	decoder->crc_errors = 0;
+	decoder->frame_errors = 0;
+	decoder->lost_blocks = 0;
+}
+
+/*
+*	Processes one received byte. Records of a previous frame that were not fetched are discarded
+*	when the next frame is complete.
+*
+*	@param decoder Decoder state
+*	@param byte Byte from the serial port
+*	@return telemetry_decode_result Result of this byte
+*/
+telemetry_decode_result telemetry_decoder_feed(telemetry_decoder* decoder, uint8_t byte) {
+	
+	if (byte != 0x00) {
+		if (decoder->length < TELEMETRY_MAX_FRAME)
+			decoder->frame[decoder->length++] = byte;
+		else
+			decoder->overflow = true;
+		return TELEMETRY_DECODE_PENDING;
+	}
+	
+	// Delimiter: the collected bytes form a frame //
+	telemetry_decode_result result = TELEMETRY_DECODE_PENDING;
+	
+	if (!decoder->synchronized) {
+		// The first frame may have been cut off by starting in its middle: keep it if it
+		// is valid, but do not count it as an error otherwise
+		unsigned long crc_errors = decoder->crc_errors;
+		unsigned long frame_errors = decoder->frame_errors;
+		
+		decoder->synchronized = true;
+		if (!decoder->overflow && decoder->length > 0)
+			result = decode_frame(decoder);
+		if (result == TELEMETRY_DECODE_ERROR) {
+			decoder->crc_errors = crc_errors;
+			decoder->frame_errors = frame_errors;
+			result = TELEMETRY_DECODE_PENDING;
+		}
+	}
+	else if (decoder->overflow) {
+		decoder->frame_errors++;
+		result = TELEMETRY_DECODE_ERROR;
+	}
+	else if (decoder->length > 0) {
+		result = decode_frame(decoder);
+	}
+	
+	decoder->length = 0;
+	decoder->overflow = false;
+	
+	return result;
+}
+
+/*
+*	Fetches the next record of the last decoded frame.
+*	@param decoder Decoder state
+*	@param record Receives the record
+*	@return bool true if a record was fetched
+*/
+bool telemetry_decoder_read(telemetry_decoder* decoder, telemetry_record* record) {
+	
+	if (decoder->ready_read >= decoder->ready_count)
+		return false;
+	
+	*record = decoder->records_ready[decoder->ready_read++];
+	return true;
+}
+
+/*
+*	CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, not reflected), as computed on the device.
+*	@param data Data to be checked
+*	@param length Number of bytes
+*	@return uint16_t CRC
+*/
+uint16_t telemetry_crc16(const uint8_t* data, unsigned length) {
+	
+	uint16_t crc = 0xFFFF;
+	
+	for (unsigned pos = 0; pos < length; pos++) {
+		crc ^= (uint16_t)data[pos] << 8;
+		for (uint8_t bit = 0; bit < 8; bit++)
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+	}
+	return crc;
+}
+
+// PRIVATE FUNCTIONS //
+/*
+*	Reverses the COBS coding of a frame (delimiter already removed).
+*	@param frame COBS coded bytes
+*	@param length Number of coded bytes
+*	@param data Destination, at least length - 1 bytes
+*	@return int Length of the payload, -1 if the coding is invalid
+*/
+static int cobs_decode(const uint8_t* frame, unsigned length, uint8_t* data) {
+	
+	unsigned in = 0;
+	int out = 0;
+	
+	while (in < length) {
+		uint8_t code = frame[in++];
+		
+		if (in + code - 1 > length)
+			return -1;
+		for (uint8_t pos = 1; pos < code; pos++)
+			data[out++] = frame[in++];
+		if (code < 0xFF && in < length)
+			data[out++] = 0x00;
+	}
+	return out;
+}
+
+/*
+*	Decodes and checks the collected frame and unpacks its records.
+*	@param decoder Decoder state
+*	@return telemetry_decode_result TELEMETRY_DECODE_RECORD, or TELEMETRY_DECODE_PENDING for
+*			a block skipped after a loss, or TELEMETRY_DECODE_ERROR
+*/
+static telemetry_decode_result decode_frame(telemetry_decoder* decoder) {
+	
+	uint8_t payload[TELEMETRY_MAX_FRAME];
+	int length = cobs_decode(decoder->frame, decoder->length, payload);
+	
+	decoder->ready_count = 0;
+	decoder->ready_read = 0;
+	
+	if (length < 1 + CRC_SIZE) {
+		decoder->frame_errors++;
+		return TELEMETRY_DECODE_ERROR;
+	}
+	
+	length -= CRC_SIZE;
+	uint16_t crc = (uint16_t)(payload[length] | (payload[length + 1] << 8));
+	if (crc != telemetry_crc16(payload, (unsigned)length)) {
+		decoder->crc_errors++;
+		return TELEMETRY_DECODE_ERROR;
+	}
+	
+	// Time and counter are restored if the frame turns out to be malformed //
+	bool time_valid = decoder->time_valid;
+	uint64_t ticks = decoder->ticks;
+	unsigned long records = decoder->records;
+	
+	bool valid;
+	switch (payload[0]) {
+		case TELEMETRY_TYPE_SAMPLE:
+			valid = decode_sample(decoder, payload, (unsigned)length);
+			break;
+		case TELEMETRY_TYPE_KEY:
+		case TELEMETRY_TYPE_DELTA:
+			valid = decode_block(decoder, payload, (unsigned)length);
+			break;
+		default:
+			valid = false;
+			break;
+	}
+	
+	if (!valid) {
+		decoder->ready_count = 0;
+		decoder->time_valid = time_valid;
+		decoder->ticks = ticks;
+		decoder->records = records;
+		decoder->frame_errors++;
+		return TELEMETRY_DECODE_ERROR;
+	}
+	return (decoder->ready_count > 0) ? TELEMETRY_DECODE_RECORD : TELEMETRY_DECODE_PENDING;
+}
+
+/*
+*	Unpacks a single-sample record.
+*	@return bool false if the record has the wrong length
+*/
+static bool decode_sample(telemetry_decoder* decoder, const uint8_t* payload, unsigned length) {
+	
+	if (length != RECORD_SIZE)
+		return false;
+	
+	add_record(decoder,
+		(uint16_t)(payload[1] | (payload[2] << 8)),
+		payload[3],
+		(uint16_t)(payload[4] | (payload[5] << 8)));
+	return true;
+}
+
+/*
+*	Unpacks a compressed block. A delta block is only used if the previous block was received;
+*	otherwise it is skipped (and counted) until the next key block restores the state.
+*
+*	@return bool false if the block is malformed
+*/
+static bool decode_block(telemetry_decoder* decoder, const uint8_t* payload, unsigned length) {
+	
+	bool key = (payload[0] == TELEMETRY_TYPE_KEY);
+	unsigned pos = key ? 4 : 2;
+	
+	if (length < pos)
+		return false;
+	
+	uint8_t sequence = payload[1];
+	uint16_t timestamp;
+	uint16_t value[TELEMETRY_CHANNELS];
+	
+	if (key) {
+		timestamp = (uint16_t)(payload[2] | (payload[3] << 8));
+		for (uint8_t channel = 0; channel < TELEMETRY_CHANNELS; channel++)
+			value[channel] = 0;
+	}
+	else {
+		if (!decoder->block_valid || sequence != decoder->next_sequence) {
+			decoder->block_valid = false;
+			decoder->lost_blocks++;
+			return true;
+		}
+		timestamp = decoder->last_timestamp;
+		for (uint8_t channel = 0; channel < TELEMETRY_CHANNELS; channel++)
+			value[channel] = decoder->last_value[channel];
+	}
+	
+	// Samples: varint(dt << 3 | channel), varint(zigzag(delta)) //
+	while (pos < length) {
+		uint32_t header, zigzag;
+		
+		if (!get_varint(payload, length, &pos, &header) || !get_varint(payload, length, &pos, &zigzag)
+			|| (header >> 3) > 0xFFFF || zigzag > 0xFFFF) {
+			decoder->block_valid = false;
+			return false;
+		}
+		
+		uint8_t channel = (uint8_t)(header & (TELEMETRY_CHANNELS - 1));
+		uint16_t delta = (uint16_t)((zigzag >> 1) ^ (0U - (zigzag & 1)));
+		
+		timestamp = (uint16_t)(timestamp + (header >> 3));
+		value[channel] = (uint16_t)(value[channel] + delta);
+		add_record(decoder, timestamp, channel, value[channel]);
+	}
+	
+	// The block was complete: continue from its state //
+	decoder->block_valid = true;
+	decoder->next_sequence = (uint8_t)(sequence + 1);
+	decoder->last_timestamp = timestamp;
+	for (uint8_t channel = 0; channel < TELEMETRY_CHANNELS; channel++)
+		decoder->last_value[channel] = value[channel];
+	
+	return true;
+}
+
+/*
+*	Reads a varint (7 Bits per byte, LSB first).
+*	@param data Payload
+*	@param length Length of the payload
+*	@param pos Position of the varint, advanced behind it
+*	@param value Receives the value
+*	@return bool false if the varint is truncated or longer than 32 Bits
+*/
+static bool get_varint(const uint8_t* data, unsigned length, unsigned* pos, uint32_t* value) {
+	
+	uint32_t result = 0;
+	
+	for (uint8_t shift = 0; shift < 32; shift += 7) {
+		if (*pos >= length)
+			return false;
+		
+		uint8_t byte = data[(*pos)++];
+		result |= (uint32_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+*	Stores a record and extends its timestamp beyond the 16-Bit wrap.
+*	@return None
+*/
+static void add_record(telemetry_decoder* decoder, uint16_t timestamp, uint8_t channel, uint16_t value) {
+	
+	if (decoder->ready_count >= TELEMETRY_MAX_RECORDS)
+		return;
+	
+	// Add the forward distance to the previous timestamp (modulo 2^16) //
+	if (decoder->time_valid)
+		decoder->ticks += (uint16_t)(timestamp - (uint16_t)decoder->ticks);
+	else
+		decoder->ticks = timestamp;
+	decoder->time_valid = true;
+	
+	telemetry_record* record = &decoder->records_ready[decoder->ready_count++];
+	record->timestamp = timestamp;
+	record->ticks = decoder->ticks;
+	record->channel = channel;
+	record->value = value;
+	
+	decoder->records++;
+}
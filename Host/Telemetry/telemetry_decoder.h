@@ -0,0 +1,100 @@
+/*
+ ***********************************************************************************
+ * @file:   telemetry_decoder.h
+ * @date:   17.10.2026
+ *
+ * Host-side decoder (PC, C99) for the binary telemetry stream of Include/Telemetry.
+ * Bytes read from the serial port are fed in one by one; every complete frame is
+ * COBS decoded, checked with the CRC-16 and unpacked into records. Single-sample
+ * frames and delta compressed blocks may be mixed in one stream; the compressed
+ * samples are restored exactly.
+ *
+ * The 16-Bit RTC timestamps of the device wrap every 2s. The decoder extends them
+ * to a 64-Bit tick count (1 tick = 1/32768 s) as long as no gap is longer than one wrap.
+ * With triggered ADC sampling (adc_startTriggered()) the device sends the number of
+ * the sample period instead; ticks then count periods of 1 / rate.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  telemetry_decoder decoder;
+  telemetry_record record;
+  telemetry_decoder_init(&decoder);
+  while (read(port, &byte, 1) == 1)
+      if (telemetry_decoder_feed(&decoder, byte) == TELEMETRY_DECODE_RECORD)
+          while (telemetry_decoder_read(&decoder, &record))
+              printf("%llu %u %u\n", record.ticks, record.channel, record.value);
+*/
+
+
+#ifndef TELEMETRY_DECODER_H_
+#define TELEMETRY_DECODER_H_
+
+// INCLUDES //
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINES //
+#define TELEMETRY_TYPE_SAMPLE		0x01	// Must match Include/Telemetry/Telemetry.h
+#define TELEMETRY_TYPE_KEY			0x02
+#define TELEMETRY_TYPE_DELTA		0x03
+#define TELEMETRY_TICKS_PER_SECOND	32768	// RTC timestamps
+
+#define TELEMETRY_MAX_FRAME			256		// Longest accepted frame (without delimiter)
+#define TELEMETRY_MAX_RECORDS		128		// Most samples a single block can hold
+#define TELEMETRY_CHANNELS			8		// Channel number is coded in 3 Bits
+
+// ENUMS //
+typedef enum {
+	TELEMETRY_DECODE_PENDING,	// Frame not complete yet
+	TELEMETRY_DECODE_RECORD,	// Records are ready, fetch them with telemetry_decoder_read()
+	TELEMETRY_DECODE_ERROR		// A frame was discarded (see the error counters)
+} telemetry_decode_result;
+
+// TYPES //
+typedef struct {
+	uint16_t timestamp;		// RTC ticks as sent by the device
+	uint64_t ticks;			// Timestamp extended beyond the 16-Bit wrap
+	uint8_t channel;		// Index into the channel table of the device
+	uint16_t value;			// Raw conversion result
+} telemetry_record;
+
+typedef struct {
+	uint8_t frame[TELEMETRY_MAX_FRAME];
+	unsigned length;			// Bytes collected of the current frame
+	bool overflow;				// Current frame is too long and will be discarded
+	bool synchronized;			// A delimiter was seen; bytes before it are ignored
+	
+	telemetry_record records_ready[TELEMETRY_MAX_RECORDS];
+	unsigned ready_count;		// Records decoded from the last frame
+	unsigned ready_read;		// Records already fetched
+	
+	bool time_valid;			// ticks holds the time of the previous record
+	uint64_t ticks;
+	
+	bool block_valid;			// Delta state below matches the device (a key block was received)
+	uint8_t next_sequence;		// Expected sequence number of the next block
+	uint16_t last_timestamp;	// Timestamp of the previous compressed sample
+	uint16_t last_value[TELEMETRY_CHANNELS];
+	
+	unsigned long records;		// Records decoded
+	unsigned long crc_errors;	// Frames with a wrong CRC
+	unsigned long frame_errors;	// Frames with invalid COBS coding, length or type
+	unsigned long lost_blocks;	// Delta blocks skipped because a previous block was lost
+} telemetry_decoder;
+
+// FUNCTION DECLARATIONS //
+void telemetry_decoder_init(telemetry_decoder* decoder);
+
+telemetry_decode_result telemetry_decoder_feed(telemetry_decoder* decoder, uint8_t byte);
+
+bool telemetry_decoder_read(telemetry_decoder* decoder, telemetry_record* record);
+
+uint16_t telemetry_crc16(const uint8_t* data, unsigned length);
+
+
+#endif /* TELEMETRY_DECODER_H_ */
@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+# Builds the host tests with gcc and runs them; call from anywhere, e.g. Host/Test/run.sh.
+# The exit code is 0 only if every test passed.
+#
+# Mikroprozessortechnik
+# Technische Hochschule Mittelhessen
+
+cd "$(dirname "$0")/../.." || exit 1
+OUT="${TMPDIR:-/tmp}/host_tests"
+CFLAGS="-std=gnu11 -O2 -Wall -Wextra -IHost/Test"
+mkdir -p "$OUT"
+status=0
+
+# run_test <name> <compiler arguments...>
+run_test() {
+	name="$1"
+	shift
+	if gcc $CFLAGS "$@" -o "$OUT/$name"; then
+		"$OUT/$name" || status=1
+	else
+		echo "$name: build failed"
+		status=1
+	fi
+}
+
+run_test test_convert -IInclude/Convert Host/Test/test_convert.c
+run_test test_format -IInclude/Format Host/Test/test_format.c Include/Format/Format.c
+run_test test_temperature -IHost/Sim -IInclude/Temperature Host/Test/test_temperature.c Include/Temperature/Temperature.c
+run_test test_parse -IInclude/Parse Host/Test/test_parse.c Include/Parse/Parse.c
+run_test test_filter -IInclude/Filter Host/Test/test_filter.c Include/Filter/Filter.c -lm
+run_test test_telemetry -IHost/Sim -IInclude/Telemetry -IInclude/USART -IInclude/ADC -IInclude/Format -IHost/Telemetry \
+	Host/Test/test_telemetry.c Include/Telemetry/Telemetry.c Host/Telemetry/telemetry_decoder.c
+
+exit $status
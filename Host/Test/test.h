@@ -0,0 +1,63 @@
+/*
+ ***********************************************************************************
+ * @file:   test.h
+ * @date:   17.10.2026
+ *
+ * Minimal checks for the host tests: every failed check prints its location and the
+ * values involved, test_summary() prints the totals and gives the exit code.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Build and run all tests from the repository root with Host/Test/run.sh.
+*/
+
+
+#ifndef TEST_H_
+#define TEST_H_
+
+// INCLUDES //
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+// DEFINES //
+#define TEST_MAX_REPORTS	10		// Failures printed in detail, further ones are only counted
+
+// Compares two integers, prints the first TEST_MAX_REPORTS differences //
+#define CHECK_EQUAL(actual, expected, ...)	test_check((long long)(actual) == (long long)(expected),	\
+		__FILE__, __LINE__, (long long)(actual), (long long)(expected), __VA_ARGS__)
+
+// Variables //
+static unsigned long test_checks = 0;
+static unsigned long test_failures = 0;
+
+// FUNCTIONS //
+__attribute__((format(printf, 6, 7)))
+static inline void test_check(int passed, const char* file, int line, long long actual, long long expected, const char* format, ...) {
+
+	test_checks++;
+	if (passed)
+		return;
+	if (++test_failures <= TEST_MAX_REPORTS) {
+		va_list arguments;
+		va_start(arguments, format);
+		fprintf(stderr, "%s:%d: got %lld, expected %lld: ", file, line, actual, expected);
+		vfprintf(stderr, format, arguments);
+		fputc('\n', stderr);
+		va_end(arguments);
+	}
+}
+
+// Prints the totals, returns the exit code of the test program //
+static inline int test_summary(const char* name) {
+	printf("%s: %lu checks, %lu failed\n", name, test_checks, test_failures);
+	return test_failures == 0 ? 0 : 1;
+}
+
+
+#endif /* TEST_H_ */
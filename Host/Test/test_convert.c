@@ -0,0 +1,60 @@
+/*
+ ***********************************************************************************
+ * @file:   test_convert.c
+ * @date:   17.10.2026
+ *
+ * Host test of Include/Convert: every kernel against the exact rational result
+ * round(value * scale / full_scale), computed with a division:
+ *  - convert_millivolt() for every 12-Bit input at the references of the project
+ *    (the header is included with CONVERT_REF_MV = 3300, the others use the same
+ *    kernel through CONVERT_FACTOR()). Not every reference is exact: at 2500mV two
+ *    inputs are off by one, so a new reference has to be added to the list here,
+ *  - convert_percent() and convert_permille() for every 12-Bit input,
+ *  - convert_calibratedPercent() for every full scale 1..4095 and every input up to it.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "test.h"
+#include "Convert.h"
+
+// Variables //
+static const uint16_t references_mv[] = { 1024, 2048, 3300 };	// VREF 1.024V, 2.048V and VDD
+
+// PRIVATE FUNCTIONS //
+// value * scale / full_scale, rounded half up //
+static uint32_t reference(uint32_t value, uint32_t scale, uint32_t full_scale) {
+	return (2 * value * scale + full_scale) / (2 * full_scale);
+}
+
+int main(void) {
+
+	for (uint16_t raw = 0; raw <= CONVERT_FULL_SCALE; raw++) {
+		CHECK_EQUAL(convert_millivolt(raw), reference(raw, CONVERT_REF_MV, CONVERT_FULL_SCALE), "millivolt(%u)", raw);
+		CHECK_EQUAL(convert_percent(raw), reference(raw, 100, CONVERT_FULL_SCALE), "percent(%u)", raw);
+		CHECK_EQUAL(convert_permille(raw), reference(raw, 1000, CONVERT_FULL_SCALE), "permille(%u)", raw);
+	}
+
+	for (uint8_t index = 0; index < sizeof(references_mv) / sizeof(references_mv[0]); index++) {
+		uint32_t ref_mv = references_mv[index];
+		uint32_t factor = CONVERT_FACTOR(ref_mv, CONVERT_MV_SHIFT);
+		for (uint16_t raw = 0; raw <= CONVERT_FULL_SCALE; raw++)
+			CHECK_EQUAL(convert_scale(raw, factor, CONVERT_MV_SHIFT), reference(raw, ref_mv, CONVERT_FULL_SCALE),
+				"millivolt(%u) at %lumV", raw, (unsigned long)ref_mv);
+	}
+
+	for (uint16_t full_scale = 1; full_scale <= CONVERT_FULL_SCALE; full_scale++) {
+		uint32_t factor = convert_calibration(full_scale);
+		for (uint16_t raw = 0; raw <= full_scale; raw++)
+			CHECK_EQUAL(convert_calibratedPercent(raw, factor), reference(raw, 100, full_scale),
+				"calibratedPercent(%u) of %u", raw, full_scale);
+	}
+
+	return test_summary("convert");
+}
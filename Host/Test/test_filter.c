@@ -0,0 +1,131 @@
+/*
+ ***********************************************************************************
+ * @file:   test_filter.c
+ * @date:   17.10.2026
+ *
+ * Host test of Include/Filter: filter_update() over the ADC traces in Host/Test/traces
+ * against reference filters written the obvious way:
+ *  - FILTER_MEDIAN3, FILTER_MEDIAN5: sorting a copy of the window, exact,
+ *  - FILTER_AVERAGE (shift 0..4): sum over the window by a loop, rounded half up, exact,
+ *  - FILTER_EMA (shift 1..8): y += (x - y) / 2^shift in double. The fixed-point state
+ *    feeds back the rounded output, which keeps it within 0.5 of the exact value, so
+ *    the output may differ from the rounded reference by 1 at most.
+ * Windows start filled with the first sample, like the module.
+ *
+ * The traces are synthetic (see the comment lines in each file); recorded traces in
+ * the same format, one raw value per line, can be added to the list below.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "test.h"
+#include "Filter.h"
+#include <stdlib.h>
+#include <math.h>
+
+// DEFINES //
+#define MAX_SAMPLES		4096
+
+// Variables //
+static const char* const traces[] = {
+	"Host/Test/traces/potentiometer.csv",
+	"Host/Test/traces/spikes.csv",
+	"Host/Test/traces/steps.csv",
+	"Host/Test/traces/temperature.csv"
+};
+
+static uint16_t samples[MAX_SAMPLES];
+
+// PRIVATE FUNCTIONS //
+// Reads one value per line, lines starting with '#' are comments; returns the count //
+static unsigned load(const char* path) {
+
+	FILE* file = fopen(path, "r");
+	if (file == NULL) {
+		fprintf(stderr, "%s: cannot open\n", path);
+		return 0;
+	}
+
+	char line[128];
+	unsigned count = 0;
+	while (count < MAX_SAMPLES && fgets(line, sizeof(line), file) != NULL) {
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+		samples[count++] = (uint16_t)strtoul(line, NULL, 10);
+	}
+	fclose(file);
+	return count;
+}
+
+// Sample n of the trace, samples before the first one repeat it //
+static uint16_t sample_at(long n) {
+	return samples[n < 0 ? 0 : n];
+}
+
+static int compare_u16(const void* a, const void* b) {
+	return (int)*(const uint16_t*)a - (int)*(const uint16_t*)b;
+}
+
+static uint16_t reference_median(unsigned n, unsigned window) {
+
+	uint16_t sorted[5];
+	for (unsigned i = 0; i < window; i++)
+		sorted[i] = sample_at((long)n - i);
+	qsort(sorted, window, sizeof(sorted[0]), compare_u16);
+	return sorted[window / 2];
+}
+
+static uint16_t reference_average(unsigned n, uint8_t shift) {
+
+	uint32_t sum = 0;
+	for (unsigned i = 0; i < (1U << shift); i++)
+		sum += sample_at((long)n - i);
+	return (uint16_t)((2 * sum + (1U << shift)) / (2U << shift));
+}
+
+static void check_trace(const char* path) {
+
+	unsigned count = load(path);
+	CHECK_EQUAL(count > 0, 1, "%s: no samples", path);
+
+	filter f;
+	for (uint8_t window = 3; window <= 5; window += 2) {
+		filter_init(&f, window == 3 ? FILTER_MEDIAN3 : FILTER_MEDIAN5, 0);
+		for (unsigned n = 0; n < count; n++) {
+			uint16_t output = filter_update(&f, samples[n]);		// CHECK_EQUAL evaluates its arguments twice
+			CHECK_EQUAL(output, reference_median(n, window), "%s: median%u at %u", path, window, n);
+		}
+	}
+
+	for (uint8_t shift = 0; shift <= 4; shift++) {
+		filter_init(&f, FILTER_AVERAGE, shift);
+		for (unsigned n = 0; n < count; n++) {
+			uint16_t output = filter_update(&f, samples[n]);
+			CHECK_EQUAL(output, reference_average(n, shift), "%s: average %u at %u", path, 1U << shift, n);
+		}
+	}
+
+	for (uint8_t shift = 1; shift <= FILTER_EMA_MAX_SHIFT; shift++) {
+		filter_init(&f, FILTER_EMA, shift);
+		double exact = samples[0];
+		for (unsigned n = 0; n < count; n++) {
+			exact += (samples[n] - exact) / (1 << shift);
+			long difference = (long)filter_update(&f, samples[n]) - (long)floor(exact + 0.5);
+			CHECK_EQUAL(labs(difference) <= 1, 1, "%s: EMA shift %u at %u differs by %ld", path, shift, n, difference);
+		}
+	}
+}
+
+int main(void) {
+
+	for (uint8_t index = 0; index < sizeof(traces) / sizeof(traces[0]); index++)
+		check_trace(traces[index]);
+
+	return test_summary("filter");
+}
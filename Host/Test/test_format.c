@@ -0,0 +1,122 @@
+/*
+ ***********************************************************************************
+ * @file:   test_format.c
+ * @date:   17.10.2026
+ *
+ * Host test of Include/Format against sprintf():
+ *  - format_u16() and format_s16() for every 16-Bit value,
+ *  - format_u32() and format_s32() for the limits, every power of ten +-1 and
+ *    a pseudo-random sweep over the 32-Bit range,
+ *  - format_decimal() with 0..9 decimals, format_fixed() with widths 0..12.
+ * Also checks the returned lengths.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "test.h"
+#include "Format.h"
+#include <string.h>
+
+// DEFINES //
+#define RANDOM_VALUES	200000UL	// Pseudo-random 32-Bit values per function
+
+// Variables //
+static uint32_t random_state = 12345;
+
+// PRIVATE FUNCTIONS //
+// xorshift32, the sweep is the same on every run //
+static uint32_t next_random(void) {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+// Compares a result with the sprintf() reference, including the returned length //
+static void compare(const char* actual, uint8_t length, const char* expected, const char* function, long long number) {
+	CHECK_EQUAL(strcmp(actual, expected), 0, "%s(%lld): \"%s\" instead of \"%s\"", function, number, actual, expected);
+	CHECK_EQUAL(length, strlen(expected), "%s(%lld): length", function, number);
+}
+
+static void check_32(uint32_t number) {
+
+	char buffer[FORMAT_DECIMAL_SIZE];
+	char expected[32];
+
+	uint8_t length = format_u32(buffer, number);
+	sprintf(expected, "%lu", (unsigned long)number);
+	compare(buffer, length, expected, "format_u32", number);
+
+	length = format_s32(buffer, (int32_t)number);
+	sprintf(expected, "%ld", (long)(int32_t)number);
+	compare(buffer, length, expected, "format_s32", (int32_t)number);
+
+	// Reference for decimals: sign, integer part, point, fraction with leading zeros //
+	int32_t value = (int32_t)number;
+	for (uint8_t decimals = 0; decimals <= 9; decimals++) {
+		uint64_t magnitude = value < 0 ? 0ULL - (int64_t)value : (uint64_t)value;
+		uint64_t scale = 1;
+		for (uint8_t digit = 0; digit < decimals; digit++)
+			scale *= 10;
+		if (decimals == 0)
+			sprintf(expected, "%ld", (long)value);
+		else
+			sprintf(expected, "%s%llu.%0*llu", value < 0 ? "-" : "", (unsigned long long)(magnitude / scale),
+				decimals, (unsigned long long)(magnitude % scale));
+		length = format_decimal(buffer, value, decimals);
+		compare(buffer, length, expected, "format_decimal", value);
+	}
+
+	// Right-aligned field, '#' if the number is too wide //
+	for (uint8_t width = 0; width <= 12; width++) {
+		char field[16];
+		sprintf(expected, "%*ld", width, (long)value);
+		if (strlen(expected) > width) {
+			memset(expected, '#', width);
+			expected[width] = '\0';
+		}
+		format_fixed(field, width, value);
+		compare(field, (uint8_t)strlen(field), expected, "format_fixed", value);
+	}
+}
+
+int main(void) {
+
+	char buffer[FORMAT_S32_SIZE];
+	char expected[16];
+
+	for (uint32_t number = 0; number <= UINT16_MAX; number++) {
+		uint8_t length = format_u16(buffer, (uint16_t)number);
+		sprintf(expected, "%u", (unsigned)number);
+		compare(buffer, length, expected, "format_u16", number);
+
+		length = format_s16(buffer, (int16_t)number);
+		sprintf(expected, "%d", (int)(int16_t)number);
+		compare(buffer, length, expected, "format_s16", (int16_t)number);
+	}
+
+	// Limits and the carries around every power of ten //
+	check_32(0);
+	check_32(UINT32_MAX);
+	check_32((uint32_t)INT32_MAX);
+	check_32((uint32_t)INT32_MIN);
+	for (uint32_t power = 1; power <= 1000000000UL; power *= 10) {
+		check_32(power - 1);
+		check_32(power);
+		check_32(power + 1);
+		check_32(0UL - power);
+	}
+
+	for (uint32_t count = 0; count < RANDOM_VALUES; count++) {
+		uint32_t number = next_random();
+		check_32(number >> (count % 32));		// Also short numbers
+	}
+
+	return test_summary("format");
+}
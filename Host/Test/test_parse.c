@@ -0,0 +1,117 @@
+/*
+ ***********************************************************************************
+ * @file:   test_parse.c
+ * @date:   17.10.2026
+ *
+ * Host test of Include/Parse: parse_fields() for every parse_status with the
+ * position it reports, covering empty fields, too many and too few fields, values
+ * above max, the digit after max / 10 (max % 10), overflow past 65535, leading
+ * zeros, blanks around fields and trailing garbage. Fields after count must not be
+ * stored.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "test.h"
+#include "Parse.h"
+
+// DEFINES //
+#define MAX_FIELDS		4
+#define UNTOUCHED		0xBEEF		// Marks values that parse_fields() must not write
+
+// TYPES //
+typedef struct {
+	const char* text;
+	uint8_t count;
+	uint16_t max;
+	parse_status status;
+	uint8_t position;
+	uint16_t values[MAX_FIELDS];	// Expected values for PARSE_OK
+} parse_case;
+
+// Variables //
+static const parse_case cases[] = {
+	// Valid lines //
+	{ "255,128,0",			3, 255,		PARSE_OK, 9,		{ 255, 128, 0 } },
+	{ " 1 , 2 ,3\r\n",		3, 255,		PARSE_OK, 11,		{ 1, 2, 3 } },
+	{ "0",					1, 0,		PARSE_OK, 1,		{ 0 } },
+	{ "65535",				1, 65535,	PARSE_OK, 5,		{ 65535 } },
+	{ "0000065535",			1, 65535,	PARSE_OK, 10,		{ 65535 } },
+	{ "1234,123",			2, 1234,	PARSE_OK, 8,		{ 1234, 123 } },
+
+	// Empty fields //
+	{ "",					1, 255,		PARSE_EMPTY_FIELD, 0,	{ 0 } },
+	{ " \r\n",				1, 255,		PARSE_EMPTY_FIELD, 3,	{ 0 } },
+	{ ",1",					2, 255,		PARSE_EMPTY_FIELD, 0,	{ 0 } },
+	{ "1,,3",				3, 255,		PARSE_EMPTY_FIELD, 2,	{ 0 } },
+	{ "1, ,3",				3, 255,		PARSE_EMPTY_FIELD, 3,	{ 0 } },
+	{ "1,2,",				3, 255,		PARSE_EMPTY_FIELD, 4,	{ 0 } },
+
+	// Number of fields //
+	{ "1,2,3,4",			3, 255,		PARSE_TOO_MANY_FIELDS, 5,	{ 0 } },
+	{ "1,2,3 ,",			3, 255,		PARSE_TOO_MANY_FIELDS, 6,	{ 0 } },
+	{ "1,2",				3, 255,		PARSE_TOO_FEW_FIELDS, 3,	{ 0 } },
+	{ "7 \r\n",				2, 255,		PARSE_TOO_FEW_FIELDS, 4,	{ 0 } },
+
+	// Above max: the position is the digit that would exceed it //
+	{ "256",				1, 255,		PARSE_OUT_OF_RANGE, 2,	{ 0 } },
+	{ "260",				1, 255,		PARSE_OUT_OF_RANGE, 2,	{ 0 } },
+	{ "1000",				1, 999,		PARSE_OUT_OF_RANGE, 3,	{ 0 } },
+	{ "10,300",				2, 255,		PARSE_OUT_OF_RANGE, 5,	{ 0 } },
+	{ "1",					1, 0,		PARSE_OUT_OF_RANGE, 0,	{ 0 } },
+
+	// max % 10: 1234 has limit 123 and last digit 4 //
+	{ "1235",				1, 1234,	PARSE_OUT_OF_RANGE, 3,	{ 0 } },
+	{ "1240",				1, 1234,	PARSE_OUT_OF_RANGE, 3,	{ 0 } },
+	{ "12340",				1, 1234,	PARSE_OUT_OF_RANGE, 4,	{ 0 } },
+
+	// Overflow past 65535 //
+	{ "65536",				1, 65535,	PARSE_OUT_OF_RANGE, 4,	{ 0 } },
+	{ "65540",				1, 65535,	PARSE_OUT_OF_RANGE, 4,	{ 0 } },
+	{ "99999",				1, 65535,	PARSE_OUT_OF_RANGE, 4,	{ 0 } },
+	{ "655350",				1, 65535,	PARSE_OUT_OF_RANGE, 5,	{ 0 } },
+	{ "1,100000",			2, 65535,	PARSE_OUT_OF_RANGE, 7,	{ 0 } },
+
+	// Invalid characters and trailing garbage //
+	{ "-1",					1, 255,		PARSE_INVALID_CHARACTER, 0,	{ 0 } },
+	{ "1;2",				2, 255,		PARSE_INVALID_CHARACTER, 1,	{ 0 } },
+	{ "12a,3",				2, 255,		PARSE_INVALID_CHARACTER, 2,	{ 0 } },
+	{ "1,2,3x",				3, 255,		PARSE_INVALID_CHARACTER, 5,	{ 0 } },
+	{ "1,2,3 x",			3, 255,		PARSE_INVALID_CHARACTER, 6,	{ 0 } },
+	{ "1,2,3.",				3, 255,		PARSE_INVALID_CHARACTER, 5,	{ 0 } },
+	{ "1,2 3",				3, 255,		PARSE_INVALID_CHARACTER, 4,	{ 0 } }
+};
+
+int main(void) {
+
+	for (uint8_t index = 0; index < sizeof(cases) / sizeof(cases[0]); index++) {
+		const parse_case* test = &cases[index];
+		uint16_t values[MAX_FIELDS + 1];
+		uint8_t position = UINT8_MAX;
+
+		for (uint8_t field = 0; field <= MAX_FIELDS; field++)
+			values[field] = UNTOUCHED;
+
+		parse_status status = parse_fields(test->text, values, test->count, test->max, &position);
+		CHECK_EQUAL(status, test->status, "\"%s\": status", test->text);
+		CHECK_EQUAL(position, test->position, "\"%s\": position", test->text);
+		CHECK_EQUAL(values[test->count], UNTOUCHED, "\"%s\": field after count written", test->text);
+
+		if (test->status == PARSE_OK) {
+			for (uint8_t field = 0; field < test->count; field++)
+				CHECK_EQUAL(values[field], test->values[field], "\"%s\": field %u", test->text, field);
+		}
+
+		// The position is optional //
+		status = parse_fields(test->text, values, test->count, test->max, NULL);
+		CHECK_EQUAL(status, test->status, "\"%s\": status without position", test->text);
+	}
+
+	return test_summary("parse");
+}
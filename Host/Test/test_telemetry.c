@@ -0,0 +1,352 @@
+/*
+ ***********************************************************************************
+ * @file:   test_telemetry.c
+ * @date:   17.10.2026
+ *
+ * Host test of Include/Telemetry against the host decoder in Host/Telemetry:
+ *  - ASCII lines and BINARY frames are read back to the samples that were sent,
+ *  - a sample that does not fit into the transmit buffer is dropped completely and
+ *    counted by telemetry_dropped(), the following frames still decode,
+ *  - a corrupted byte is rejected by the CRC,
+ *  - a payload with 0x00 bytes is COBS coded without any zero before the delimiter,
+ *  - COMPRESSED blocks restore a stream with full-scale jumps (0 <-> 0xFFF0 and steps
+ *    of 0x8000, the largest zig-zag value), timestamp steps up to 0xFFFF and several
+ *    16-Bit wraps, including the extended tick count,
+ *  - after a lost delta block the following delta blocks are skipped and counted,
+ *    and decoding resumes exactly with the next key block.
+ * The USART is replaced by a stub that records the queued bytes; usart_txFree()
+ * returns tx_free, so a full transmit buffer is simulated by lowering it.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "test.h"
+#include "Telemetry.h"
+#include "USART.h"
+#include "telemetry_decoder.h"
+#include <string.h>
+
+// DEFINES //
+#define TX_CAPTURE		8192
+#define STREAM_SAMPLES	400		// Compressed stream, enough for more than TELEMETRY_KEY_INTERVAL blocks
+#define STREAM_FRAMES	64
+#define LOST_FRAME		2		// Delta block left out by the lossy receiver
+
+// Variables //
+static uint8_t tx[TX_CAPTURE];			// Bytes queued since the last tx_clear()
+static unsigned tx_length = 0;
+static uint8_t tx_free = USART_TX_BUFFER_SIZE - 1;	// Free space reported to the module
+
+static const adc_sample samples[] = {
+	{ 0, 0, 0 }, { 1, 1, 4095 }, { 256, 2, 0x0100 }, { 0x1234, 3, 0x8000 },
+	{ 0xFFFF, 7, 0xFFFF }, { 0x00FF, 0, 0xFF00 }, { 42, 5, 1 }, { 0x8000, 4, 0x0123 }
+};
+#define SAMPLE_COUNT	(sizeof(samples) / sizeof(samples[0]))
+static const adc_sample no_zeros = { 0x1234, 3, 0x0123 };	// Record and CRC without a zero byte
+
+static adc_sample stream[STREAM_SAMPLES];
+static uint64_t stream_ticks[STREAM_SAMPLES];	// Time of each sample without the 16-Bit wrap
+static telemetry_record records[STREAM_SAMPLES + 1];
+
+// USART STUB //
+uint8_t usart_write(const uint8_t* data, uint8_t length) {
+	memcpy(&tx[tx_length], data, length);
+	tx_length += length;
+	return length;
+}
+
+uint8_t usart_putChar(char character) {
+	tx[tx_length++] = (uint8_t)character;
+	return 1;
+}
+
+uint8_t usart_putUnsigned(uint32_t number) {
+	int length = sprintf((char*)&tx[tx_length], "%lu", (unsigned long)number);
+	tx_length += (unsigned)length;
+	return (uint8_t)length;
+}
+
+uint8_t usart_txFree(void) {
+	return tx_free;
+}
+
+// PRIVATE FUNCTIONS //
+static void tx_clear(void) {
+	tx_length = 0;
+	tx_free = USART_TX_BUFFER_SIZE - 1;
+}
+
+static void check_record(const telemetry_record* record, const adc_sample* sample, const char* mode, unsigned index) {
+	CHECK_EQUAL(record->timestamp, sample->timestamp, "%s: timestamp of sample %u", mode, index);
+	CHECK_EQUAL(record->channel, sample->channel, "%s: channel of sample %u", mode, index);
+	CHECK_EQUAL(record->value, sample->value, "%s: value of sample %u", mode, index);
+}
+
+// Feeds the captured bytes; returns the number of records, which are stored in records //
+static unsigned decode(telemetry_decoder* decoder, const uint8_t* data, unsigned length, telemetry_record* records, unsigned size) {
+
+	unsigned count = 0;
+	for (unsigned pos = 0; pos < length; pos++) {
+		if (telemetry_decoder_feed(decoder, data[pos]) != TELEMETRY_DECODE_RECORD)
+			continue;
+		while (count < size && telemetry_decoder_read(decoder, &records[count]))
+			count++;
+	}
+	return count;
+}
+
+static void check_ascii(void) {
+
+	telemetry_setMode(TELEMETRY_ASCII);
+	tx_clear();
+	for (unsigned index = 0; index < SAMPLE_COUNT; index++) {
+		bool sent = telemetry_send(&samples[index]);
+		CHECK_EQUAL(sent, 1, "ascii: sample %u not sent", index);
+	}
+
+	tx[tx_length] = '\0';
+	const char* line = (const char*)tx;
+	for (unsigned index = 0; index < SAMPLE_COUNT; index++) {
+		unsigned timestamp, channel, value;
+		int length = 0;
+		int fields = sscanf(line, "%u,%u,%u\n%n", &timestamp, &channel, &value, &length);
+		CHECK_EQUAL(fields, 3, "ascii: line %u", index);
+		if (fields != 3)
+			return;
+		telemetry_record record = { (uint16_t)timestamp, 0, (uint8_t)channel, (uint16_t)value };
+		check_record(&record, &samples[index], "ascii", index);
+		line += length;
+	}
+	CHECK_EQUAL(*line, '\0', "ascii: bytes after the last line");
+}
+
+static void check_binary(void) {
+
+	telemetry_setMode(TELEMETRY_BINARY);
+	tx_clear();
+	for (unsigned index = 0; index < SAMPLE_COUNT; index++) {
+		unsigned before = tx_length;
+		bool sent = telemetry_send(&samples[index]);
+		CHECK_EQUAL(sent, 1, "binary: sample %u not sent", index);
+		CHECK_EQUAL(tx_length - before, TELEMETRY_FRAME_SIZE, "binary: frame length of sample %u", index);
+
+		// COBS: the only zero of a frame is its delimiter //
+		for (unsigned pos = before; pos < tx_length - 1; pos++)
+			CHECK_EQUAL(tx[pos] != 0, 1, "binary: zero at %u in the frame of sample %u", pos - before, index);
+		CHECK_EQUAL(tx[tx_length - 1], 0, "binary: delimiter of sample %u", index);
+	}
+
+	telemetry_decoder decoder;
+	telemetry_record records[SAMPLE_COUNT + 1];
+	telemetry_decoder_init(&decoder);
+	unsigned count = decode(&decoder, tx, tx_length, records, SAMPLE_COUNT + 1);
+
+	CHECK_EQUAL(count, SAMPLE_COUNT, "binary: records decoded");
+	for (unsigned index = 0; index < count && index < SAMPLE_COUNT; index++)
+		check_record(&records[index], &samples[index], "binary", index);
+	CHECK_EQUAL(decoder.crc_errors + decoder.frame_errors, 0, "binary: errors");
+}
+
+static void check_dropped(void) {
+
+	static const telemetry_mode modes[] = { TELEMETRY_ASCII, TELEMETRY_BINARY };
+
+	for (uint8_t m = 0; m < 2; m++) {
+		telemetry_setMode(modes[m]);
+		tx_clear();
+		uint8_t dropped = telemetry_dropped();
+
+		bool sent = telemetry_send(&samples[1]);
+		CHECK_EQUAL(sent, 1, "dropped, mode %u: first sample", m);
+		unsigned length = tx_length;
+
+		// One byte less than the frame (or the longest line) needs //
+		tx_free = (modes[m] == TELEMETRY_BINARY) ? TELEMETRY_FRAME_SIZE - 1 : 15;
+		sent = telemetry_send(&samples[3]);
+		CHECK_EQUAL(sent, 0, "dropped, mode %u: sample sent into a full buffer", m);
+		CHECK_EQUAL(tx_length, length, "dropped, mode %u: bytes queued for a dropped sample", m);
+		CHECK_EQUAL(telemetry_dropped(), dropped + 1, "dropped, mode %u: not counted", m);
+
+		tx_free = USART_TX_BUFFER_SIZE - 1;
+		sent = telemetry_send(&samples[4]);
+		CHECK_EQUAL(sent, 1, "dropped, mode %u: sample after the full buffer", m);
+
+		if (modes[m] == TELEMETRY_BINARY) {
+			telemetry_decoder decoder;
+			telemetry_record records[3];
+			telemetry_decoder_init(&decoder);
+			unsigned count = decode(&decoder, tx, tx_length, records, 3);
+
+			CHECK_EQUAL(count, 2, "dropped: records decoded");
+			if (count == 2) {
+				check_record(&records[0], &samples[1], "dropped", 0);
+				check_record(&records[1], &samples[4], "dropped", 1);
+			}
+			CHECK_EQUAL(decoder.crc_errors + decoder.frame_errors, 0, "dropped: errors");
+		}
+	}
+}
+
+static void check_corrupted(void) {
+
+	telemetry_setMode(TELEMETRY_BINARY);
+	tx_clear();
+	bool sent = telemetry_send(&no_zeros);
+	CHECK_EQUAL(sent, 1, "corrupted: sample not sent");
+	CHECK_EQUAL(tx[0], TELEMETRY_FRAME_SIZE - 1, "corrupted: COBS code byte");
+
+	// Flip one bit of every payload byte in turn; the code byte keeps the COBS structure valid //
+	for (unsigned pos = 1; pos < tx_length - 1; pos++) {
+		uint8_t frame[TELEMETRY_FRAME_SIZE];
+		memcpy(frame, tx, tx_length);
+		frame[pos] ^= (frame[pos] == 0x01) ? 0x02 : 0x01;
+
+		telemetry_decoder decoder;
+		telemetry_decoder_init(&decoder);
+		telemetry_decoder_feed(&decoder, 0x00);		// Synchronize: the next frame counts
+
+		telemetry_decode_result result = TELEMETRY_DECODE_PENDING;
+		for (unsigned index = 0; index < tx_length; index++)
+			result = telemetry_decoder_feed(&decoder, frame[index]);
+
+		CHECK_EQUAL(result, TELEMETRY_DECODE_ERROR, "corrupted: byte %u accepted", pos);
+		CHECK_EQUAL(decoder.records, 0, "corrupted: records from byte %u", pos);
+		CHECK_EQUAL(decoder.crc_errors, 1, "corrupted: CRC errors for byte %u", pos);
+		CHECK_EQUAL(decoder.frame_errors, 0, "corrupted: frame errors for byte %u", pos);
+	}
+}
+
+static void check_zeros(void) {
+
+	// type 0x01, timestamp 0x0000, channel 0, value 0x0000: four zero bytes in the record //
+	telemetry_setMode(TELEMETRY_BINARY);
+	tx_clear();
+	bool sent = telemetry_send(&samples[0]);
+	CHECK_EQUAL(sent, 1, "zeros: sample not sent");
+	CHECK_EQUAL(tx_length, TELEMETRY_FRAME_SIZE, "zeros: frame length");
+
+	uint8_t zeros = 0;
+	for (unsigned pos = 0; pos < tx_length; pos++)
+		zeros += (tx[pos] == 0);
+	CHECK_EQUAL(zeros, 1, "zeros: zero bytes in the frame");
+	CHECK_EQUAL(tx[0], 2, "zeros: COBS code byte before the first zero");
+
+	telemetry_decoder decoder;
+	telemetry_record record;
+	telemetry_decoder_init(&decoder);
+	unsigned count = decode(&decoder, tx, tx_length, &record, 1);
+	CHECK_EQUAL(count, 1, "zeros: records decoded");
+	if (count == 1)
+		check_record(&record, &samples[0], "zeros", 0);
+}
+
+// Samples on three channels: full-scale jumps, a ramp and a constant value //
+static void build_stream(void) {
+
+	static const uint16_t jumps[] = { 0, 0xFFF0, 0, 0xFFF0, 0x8000, 0, 0x8000, 0xFFF0 };
+	static const uint16_t steps[] = { 1, 1000, 0xFFFF, 0, 33000 };
+	uint64_t ticks = 0xFFF0;		// Wraps with the second sample
+
+	for (unsigned index = 0; index < STREAM_SAMPLES; index++) {
+		uint8_t channel = index % 3;
+		stream[index].channel = channel;
+		stream[index].value = (channel == 0) ? jumps[(index / 3) % 8] : (channel == 1) ? (uint16_t)((index * 7) & 0xFFF) : 0xFFF0;
+		stream[index].timestamp = (uint16_t)ticks;
+		stream_ticks[index] = ticks;
+		ticks += steps[index % 5];
+	}
+}
+
+// Splits the captured bytes into frames, returns their number; frame n ends before start[n + 1] //
+static unsigned split_frames(unsigned* start) {
+
+	unsigned count = 0;
+	start[0] = 0;
+	for (unsigned pos = 0; pos < tx_length && count < STREAM_FRAMES; pos++) {
+		if (tx[pos] == 0x00)
+			start[++count] = pos + 1;
+	}
+	return count;
+}
+
+static void check_compressed(void) {
+
+	build_stream();
+	telemetry_setMode(TELEMETRY_BINARY);
+	telemetry_setMode(TELEMETRY_COMPRESSED);		// The mode change starts with a key block
+	tx_clear();
+	for (unsigned index = 0; index < STREAM_SAMPLES; index++) {
+		bool sent = telemetry_send(&stream[index]);
+		CHECK_EQUAL(sent, 1, "compressed: sample %u not sent", index);
+	}
+	bool flushed = telemetry_flush();
+	CHECK_EQUAL(flushed, 1, "compressed: last block not sent");
+
+	unsigned start[STREAM_FRAMES + 1];
+	unsigned frames = split_frames(start);
+	CHECK_EQUAL(frames > TELEMETRY_KEY_INTERVAL, 1, "compressed: only %u blocks", frames);
+	CHECK_EQUAL(start[frames], tx_length, "compressed: bytes after the last frame");
+	if (frames <= TELEMETRY_KEY_INTERVAL)
+		return;
+
+	// Receiver without loss: every sample, ticks continue across the wraps //
+	unsigned first[STREAM_FRAMES + 1];		// Index of the first record of each frame
+	telemetry_decoder decoder;
+	telemetry_decoder_init(&decoder);
+	unsigned count = 0;
+	for (unsigned frame = 0; frame < frames; frame++) {
+		first[frame] = count;
+		count += decode(&decoder, &tx[start[frame]], start[frame + 1] - start[frame], &records[count], STREAM_SAMPLES + 1 - count);
+	}
+	first[frames] = count;
+
+	CHECK_EQUAL(count, STREAM_SAMPLES, "compressed: records decoded");
+	for (unsigned index = 0; index < count && index < STREAM_SAMPLES; index++) {
+		check_record(&records[index], &stream[index], "compressed", index);
+		CHECK_EQUAL(records[index].ticks, stream_ticks[index], "compressed: ticks of sample %u", index);
+	}
+	CHECK_EQUAL(decoder.crc_errors + decoder.frame_errors + decoder.lost_blocks, 0, "compressed: errors");
+
+	// Receiver missing one delta block: nothing until the next key block, then exact again //
+	telemetry_decoder_init(&decoder);
+	for (unsigned frame = 0; frame < frames; frame++) {
+		if (frame == LOST_FRAME)
+			continue;
+
+		telemetry_record record;
+		unsigned index = first[frame];
+		for (unsigned pos = start[frame]; pos < start[frame + 1]; pos++) {
+			telemetry_decode_result result = telemetry_decoder_feed(&decoder, tx[pos]);
+			while (telemetry_decoder_read(&decoder, &record)) {
+				CHECK_EQUAL(frame < LOST_FRAME || frame >= TELEMETRY_KEY_INTERVAL, 1, "lost block: record from block %u", frame);
+				if (index < first[frame + 1])
+					check_record(&record, &stream[index], "lost block", index);
+				index++;
+			}
+			if (pos == start[frame + 1] - 1 && frame > LOST_FRAME && frame < TELEMETRY_KEY_INTERVAL)
+				CHECK_EQUAL(result, TELEMETRY_DECODE_PENDING, "lost block: result for block %u", frame);
+		}
+		if (frame < LOST_FRAME || frame >= TELEMETRY_KEY_INTERVAL)
+			CHECK_EQUAL(index, first[frame + 1], "lost block: records of block %u", frame);
+	}
+	CHECK_EQUAL(decoder.lost_blocks, TELEMETRY_KEY_INTERVAL - LOST_FRAME - 1, "lost block: skipped blocks");
+	CHECK_EQUAL(decoder.crc_errors + decoder.frame_errors, 0, "lost block: errors");
+}
+
+int main(void) {
+
+	check_ascii();
+	check_binary();
+	check_dropped();
+	check_corrupted();
+	check_zeros();
+	check_compressed();
+
+	return test_summary("telemetry");
+}
@@ -0,0 +1,55 @@
+/*
+ ***********************************************************************************
+ * @file:   test_temperature.c
+ * @date:   17.10.2026
+ *
+ * Host test of Include/Temperature: temperature_centiKelvin() with its 32-Bit
+ * arithmetic against the product (TEMPSENSE1 - value) * TEMPSENSE0 * 100 / 2^16
+ * computed in 64 Bit and rounded half up, for every 12-Bit and every accumulated
+ * 16-Bit result and calibrations from the smallest to the largest slope.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "test.h"
+#include "Temperature.h"
+
+// Variables //
+SIGROW_t SIGROW;		// Signature row, filled by the test before temperature_init()
+
+static const uint16_t slopes[] = { 1, 3500, 4096, 40000, 65535 };
+static const uint16_t offsets[] = { 0, 2500, 4095 };
+
+// PRIVATE FUNCTIONS //
+// Temperature in 0.01K from the calibration and a result in 1/16 LSB //
+static int32_t reference(uint16_t slope, uint16_t offset, uint32_t scaled) {
+	int64_t product = ((int64_t)offset * 16 - scaled) * slope * 100;
+	return (int32_t)((product + 32768) >> 16);
+}
+
+int main(void) {
+
+	for (uint8_t s = 0; s < sizeof(slopes) / sizeof(slopes[0]); s++) {
+		for (uint8_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+			SIGROW.TEMPSENSE0 = slopes[s];
+			SIGROW.TEMPSENSE1 = offsets[o];
+			temperature_init();
+
+			for (uint32_t value = 0; value <= 0xFFFF; value++) {
+				CHECK_EQUAL(temperature_centiKelvin(value, ADC_SAMPNUM_ACC16_gc), reference(slopes[s], offsets[o], value),
+					"centiKelvin(%lu) slope %u offset %u", (unsigned long)value, slopes[s], offsets[o]);
+				if (value < 4096)
+					CHECK_EQUAL(temperature_centiKelvin(value, ADC_SAMPNUM_NONE_gc), reference(slopes[s], offsets[o], value << 4),
+						"centiKelvin(%lu, 12 Bit) slope %u offset %u", (unsigned long)value, slopes[s], offsets[o]);
+			}
+		}
+	}
+
+	return test_summary("temperature");
+}
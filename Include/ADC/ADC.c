@@ -0,0 +1,342 @@
+/*
+ ***********************************************************************************
+ * @file:   ADC.c
+ * @date:   17.10.2026
+ *
+ * This module runs ADC0 continuously. Every result is stored together with
+ * a timestamp in a ring buffer by the RESRDY interrupt, so conversions continue
+ * while the main program is busy with the LCD or the USART.
+ *
+ * A scan list of several channels is converted round-robin: the RESRDY interrupt
+ * reconfigures the ADC for the next channel and starts its conversion (or leaves the
+ * start to the next timer event in triggered mode).
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "ADC.h"
+#include "RTC.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+// DEFINES //
+#ifndef F_CPU
+#define F_CPU 4000000UL
+#endif
+
+#define BUFFER_MASK		(ADC_BUFFER_SIZE - 1)
+#define ISR_CYCLES		200			// Margin for the RESRDY interrupt between two triggered conversions
+
+#if (ADC_BUFFER_SIZE & BUFFER_MASK) != 0 || ADC_BUFFER_SIZE > 128
+#error "ADC_BUFFER_SIZE must be a power of two and not larger than 128"
+#endif
+
+#if ADC_MAX_CHANNELS > 8
+#error "ADC_MAX_CHANNELS must not be larger than 8"
+#endif
+
+// Variables //
+static volatile adc_sample buffer[ADC_BUFFER_SIZE];
+static volatile uint8_t head = 0;			// Next free slot, only written by the RESRDY interrupt
+static volatile uint8_t tail = 0;			// Oldest unread sample, only written by the main program
+static volatile uint8_t overruns = 0;		// Samples lost because the ring buffer was full
+
+static const adc_channel* scan_list;		// Channel table given to adc_init()
+static uint8_t scan_count = 0;				// Number of channels in the table
+static volatile uint8_t scan_index = 0;		// Channel of the running conversion
+static volatile bool running = false;		// Scan is active (cleared by adc_stop())
+static bool triggered = false;				// Conversions are started by TCA1 events
+static uint16_t shortest_ticks = 0;			// Shortest conversion of the scan list in TCA1 counts
+static uint8_t result_shift[ADC_MAX_CHANNELS];	// Left shift aligning an accumulated result to 16 Bit
+
+static volatile adc_sample latest[ADC_MAX_CHANNELS];	// Most recent sample per channel
+static volatile uint8_t latest_valid = 0;	// Bit n: channel n has completed at least one conversion
+
+// PRIVATE FUNCTION DECLARATIONS //
+static void select(uint8_t index);
+static uint32_t conversion_cycles(bool longest);
+static uint16_t period_number(void);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Configures ADC0 for 12-Bit conversions of the given scan list
+*	and starts the RTC as timestamp source.
+*
+*	@param channels Table with input, reference and timing of each channel (must stay valid)
+*	@param count Number of channels in the table (1 .. ADC_MAX_CHANNELS)
+*	@return None
+*/
+void adc_init(const adc_channel* channels, uint8_t count) {
+	
+	if (count > ADC_MAX_CHANNELS)
+		count = ADC_MAX_CHANNELS;
+	scan_list = channels;
+	scan_count = count;
+	latest_valid = 0;
+	
+	rtc_init();										// Timestamp source
+	
+	// Sum of 2^n 12-Bit conversions has 12 + n Bits. For more than 16 samples the ADC
+	// already truncates the sum to 16 Bit (Data sheet -> ADC -> Accumulation).
+	for (uint8_t index = 0; index < count; index++) {
+		uint8_t n = channels[index].sampnum & ADC_SAMPNUM_gm;
+		result_shift[index] = (n == 0 || n >= 4) ? 0 : 4 - n;
+	}
+	
+	// ADC Configuration //
+	ADC0.CTRLC = ADC_PRESCALER;						// Prescaler
+	ADC0.INTCTRL = ADC_RESRDY_bm;					// Interrupt on every result
+	select(0);
+	ADC0.CTRLA = ADC_ENABLE_bm | ADC_RESSEL_12BIT_gc;	// 12-Bit, free-running is selected by adc_start()
+}
+
+/*
+*	Starts the free-running conversions.
+*	@return None
+*/
+void adc_start(void) {
+	
+	if (scan_count == 0)
+		return;
+	
+	running = true;
+	triggered = false;
+	scan_index = 0;
+	select(0);
+	ADC0.EVCTRL = 0;
+	
+	if (scan_count == 1)
+		ADC0.CTRLA |= ADC_FREERUN_bm;		// Single channel: hardware restarts the conversions
+	ADC0.COMMAND = ADC_STCONV_bm;
+}
+
+/*
+*	Stops the free-running or triggered conversions after the current one.
+*	@return None
+*/
+void adc_stop(void) {
+	running = false;
+	ADC0.CTRLA &= ~ADC_FREERUN_bm;
+	
+	if (triggered) {
+		TCA1.SINGLE.CTRLA = 0;
+		TCB0.CTRLA = 0;
+		ADC0.EVCTRL = 0;
+		EVSYS.USERADC0START = 0;
+		EVSYS.USERTCB0COUNT = 0;
+		triggered = false;
+	}
+}
+
+/*
+*	Starts conversions at a fixed rate: every overflow of TCA1 starts one conversion
+*	through event channel 0, without CPU involvement. TCB0 counts the same events, so
+*	samples are stamped with the number of their period even if a result was lost
+*	(wraps after 65536 periods).
+*
+*	@param rate Conversions per second (all channels together), F_CPU / 2^26 .. limit of the ADC timing
+*	@return bool false if the rate cannot be reached: slower than the timer or faster than a conversion
+*/
+bool adc_startTriggered(uint32_t rate) {
+	
+	static const uint16_t dividers[] = { 1, 2, 4, 8, 16, 64, 256, 1024 };
+	
+	if (scan_count == 0 || rate == 0)
+		return false;
+	if ((F_CPU + rate / 2) / rate < conversion_cycles(true))
+		return false;		// Next event would arrive during a conversion and be lost
+	
+	// Smallest prescaler whose period fits into 16 Bit gives the finest rate //
+	uint8_t clksel = 0;
+	uint32_t ticks = 0;
+	for (; clksel < sizeof(dividers) / sizeof(dividers[0]); clksel++) {
+		uint32_t step = rate * dividers[clksel];
+		ticks = (F_CPU + step / 2) / step;
+		if (ticks <= 0x10000UL)
+			break;
+	}
+	if (clksel == sizeof(dividers) / sizeof(dividers[0]))
+		return false;
+	
+	adc_stop();
+	
+	running = true;
+	triggered = true;
+	shortest_ticks = conversion_cycles(false) / dividers[clksel];
+	scan_index = 0;
+	select(0);
+	
+	TCB0.CTRLA = 0;
+	TCB0.CTRLB = TCB_CNTMODE_INT_gc;
+	TCB0.CCMP = 0xFFFF;									// Wraps like the 16-Bit timestamp
+	TCB0.CNT = 0;
+	TCB0.CTRLA = TCB_CLKSEL_EVENT_gc | TCB_ENABLE_bm;	// Counts the TCA1 overflows
+	
+	TCA1.SINGLE.CTRLA = 0;
+	TCA1.SINGLE.CTRLB = TCA_SINGLE_WGMODE_NORMAL_gc;
+	TCA1.SINGLE.CNT = 0;
+	TCA1.SINGLE.PER = ticks - 1;
+	
+	EVSYS.CHANNEL0 = EVSYS_CHANNEL0_TCA1_OVF_LUNF_gc;	// Generator: TCA1 overflow
+	EVSYS.USERADC0START = EVSYS_USER_CHANNEL0_gc;		// User: start of conversion
+	EVSYS.USERTCB0COUNT = EVSYS_USER_CHANNEL0_gc;		// User: period counter
+	ADC0.EVCTRL = ADC_STARTEI_bm;
+	
+	TCA1.SINGLE.CTRLA = (clksel << 1) | TCA_SINGLE_ENABLE_bm;
+	
+	return true;
+}
+
+/*
+*	Returns the most recent sample of a channel without removing anything from the ring buffer.
+*	@param channel Index into the channel table
+*	@param sample Storage for the sample
+*	@return bool false if the channel has not completed a conversion yet
+*/
+bool adc_latest(uint8_t channel, adc_sample* sample) {
+	
+	if (channel >= scan_count || !(latest_valid & (1 << channel)))
+		return false;
+	
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		sample->timestamp = latest[channel].timestamp;
+		sample->value = latest[channel].value;
+	}
+	sample->channel = channel;
+	
+	return true;
+}
+
+/*
+*	Removes the oldest sample from the ring buffer.
+*	@param sample Storage for the sample
+*	@return bool false if the ring buffer is empty
+*/
+bool adc_read(adc_sample* sample) {
+	
+	uint8_t position = tail;
+	if (position == head)
+		return false;
+	
+	sample->timestamp = buffer[position].timestamp;
+	sample->channel = buffer[position].channel;
+	sample->value = buffer[position].value;
+	tail = (position + 1) & BUFFER_MASK;
+	
+	return true;
+}
+
+/*
+*	@return uint8_t Number of samples waiting in the ring buffer
+*/
+uint8_t adc_available(void) {
+	return (uint8_t)(head - tail) & BUFFER_MASK;
+}
+
+/*
+*	@return uint8_t Number of samples lost because the ring buffer was full
+*/
+uint8_t adc_overruns(void) {
+	return overruns;
+}
+
+// PRIVATE FUNCTIONS //
+// Applies the configuration of one channel of the scan list //
+static void select(uint8_t index) {
+	
+	const adc_channel* channel = &scan_list[index];
+	
+	VREF.ADC0REF = channel->reference;				// Reference voltage
+	ADC0.MUXPOS = channel->muxpos;					// Input
+	ADC0.CTRLB = channel->sampnum & ADC_SAMPNUM_gm;	// Hardware accumulation
+	ADC0.CTRLD = channel->initdly;					// Delay after reference changes
+	ADC0.SAMPCTRL = channel->sampctrl;				// Sample length
+}
+
+// Longest conversion of the scan list in CPU cycles including the interrupt, or the shortest without //
+static uint32_t conversion_cycles(bool longest) {
+	
+	static const uint8_t prescaler[] = { 2, 4, 6, 8, 10, 12, 14, 16, 20, 24, 28, 32, 40, 48, 56, 64 };
+	uint32_t most = 0;
+	uint32_t least = UINT32_MAX;
+	
+	for (uint8_t index = 0; index < scan_count; index++) {
+		const adc_channel* channel = &scan_list[index];
+		
+		// Sampling (SAMPCTRL + 2) and 13 conversion cycles of CLK_ADC per accumulated result //
+		uint32_t clocks = ((uint32_t)channel->sampctrl + 2 + 13) << (channel->sampnum & ADC_SAMPNUM_gm);
+		if (clocks < least)
+			least = clocks;
+		
+		// Channels may switch the reference, which inserts the initialization delay //
+		uint8_t initdly = (channel->initdly & ADC_INITDLY_gm) >> 5;
+		if (scan_count > 1 && initdly != 0)
+			clocks += 16U << (initdly - 1);
+		
+		if (clocks > most)
+			most = clocks;
+	}
+	
+	if (!longest)
+		return least * prescaler[ADC_PRESCALER & ADC_PRESC_gm];
+	return most * prescaler[ADC_PRESCALER & ADC_PRESC_gm] + ISR_CYCLES;
+}
+
+// Number of the TCA1 period whose overflow started the conversion that just ended //
+static uint16_t period_number(void) {
+	
+	uint16_t position = TCA1.SINGLE.CNT;
+	uint16_t count = TCB0.CNT;				// Overflows so far
+	if (TCA1.SINGLE.CNT < position)
+		count--;							// Overflow between the two reads: belongs to position
+	
+	// A period younger than the shortest conversion cannot have produced this result, //
+	// the conversion started with the overflow before //
+	if (position < shortest_ticks)
+		count--;
+	
+	return count - 1;						// The first overflow starts period 0
+}
+
+// INTERRUPTS //
+ISR(ADC0_RESRDY_vect) {
+	
+	uint8_t channel = scan_index;
+	uint16_t value = ADC0.RES << result_shift[channel];		// Reading the result clears the interrupt flag
+	uint16_t timestamp = triggered ? period_number() : RTC.CNT;
+	
+	// Continue the scan with the next channel //
+	if (scan_count > 1) {
+		uint8_t next = channel + 1;
+		if (next == scan_count)
+			next = 0;
+		scan_index = next;
+		
+		if (running) {
+			select(next);
+			if (!triggered)
+				ADC0.COMMAND = ADC_STCONV_bm;	// Triggered: the next event starts it
+		}
+	}
+	
+	latest[channel].timestamp = timestamp;
+	latest[channel].value = value;
+	latest_valid |= (1 << channel);
+	
+	uint8_t position = head;
+	uint8_t next = (position + 1) & BUFFER_MASK;
+	if (next == tail) {
+		overruns++;
+		return;
+	}
+	buffer[position].timestamp = timestamp;
+	buffer[position].channel = channel;
+	buffer[position].value = value;
+	head = next;
+}
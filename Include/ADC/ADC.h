@@ -0,0 +1,104 @@
+/*
+ ***********************************************************************************
+ * @file:   ADC.h
+ * @date:   17.10.2026
+ *
+ * This module runs ADC0 continuously. Every result is stored together with
+ * a timestamp in a ring buffer by the RESRDY interrupt, so conversions continue
+ * while the main program is busy with the LCD or the USART.
+ *
+ * The module converts a scan list of up to ADC_MAX_CHANNELS channels. With a single
+ * channel the ADC runs in free-running mode. With more channels the RESRDY interrupt
+ * switches input, reference and timing to the next channel of the list and starts
+ * its conversion, so all channels are sampled round-robin at
+ * (conversion rate / number of channels) each.
+ *
+ * Optionally the hardware accumulator sums 2..128 conversions per result
+ * (oversampling). The driver scales the sum to a left-aligned 16-Bit value:
+ * full scale is ADC_MAX_OVERSAMPLED and 12 + log2(samples) / 2 of the bits are significant
+ * (e.g. 16 samples -> 14 effective bits). Without accumulation results stay 12-Bit.
+ *
+ * Timestamps are taken from the RTC counter, clocked by the internal 32.768kHz
+ * oscillator (1 tick = 30.5us, wraps every 2s).
+ *
+ * Instead of free-running, adc_startTriggered() lets the overflow of TCA1 start every
+ * conversion through event channel 0 (EVSYS -> ADC0 start event). The sample period
+ * is exact and independent of the CPU load; with a scan list each period converts the
+ * next channel. In this mode the timestamp of a sample is the number of its timer period:
+ * TCB0 counts the TCA1 overflows through the same event channel, so a period whose
+ * result was lost (e.g. interrupts blocked for longer than a period) leaves a gap.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  1. Call adc_init() with the channel table, enable global interrupts (sei())
+     and call adc_start(). The table must stay valid while the ADC is running.
+     For a fixed sample rate call adc_startTriggered(rate) instead (TCA1, TCB0 and
+     event channel 0 are then used by this module).
+  2. Use adc_latest() for the most recent result of a channel or drain all results
+     in order with adc_read().
+*/
+
+
+#ifndef ADC_H_
+#define ADC_H_
+
+// INCLUDES //
+#include <avr/io.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINES //
+#ifndef ADC_BUFFER_SIZE
+#define ADC_BUFFER_SIZE		32		// Number of samples in the ring buffer (power of two, max. 128)
+#endif
+
+#ifndef ADC_MAX_CHANNELS
+#define ADC_MAX_CHANNELS	4		// Maximum length of the scan list
+#endif
+
+#ifndef ADC_PRESCALER
+#define ADC_PRESCALER		ADC_PRESC_DIV16_gc	// CLK_ADC = CLK_PER / 16 (max. 2MHz for 12-Bit)
+#endif
+
+#define ADC_MAX_VALUE		4095	// Full scale of a 12-Bit result
+#define ADC_MAX_OVERSAMPLED	0xFFF0	// Full scale of an accumulated result
+
+// TYPES //
+typedef struct {
+	uint8_t muxpos;			// Input, e.g. ADC_MUXPOS_AIN19_gc
+	uint8_t reference;		// Reference voltage, e.g. VREF_REFSEL_VDD_gc
+	uint8_t initdly;		// Delay after a reference change, e.g. ADC_INITDLY_DLY64_gc
+	uint8_t sampctrl;		// Additional sample length in ADC clock cycles
+	uint8_t sampnum;		// Accumulated conversions per result, ADC_SAMPNUM_NONE_gc .. ADC_SAMPNUM_ACC128_gc
+} adc_channel;
+
+typedef struct {
+	uint16_t timestamp;		// RTC ticks at the end of the conversion (triggered: number of the period)
+	uint8_t channel;		// Index into the channel table
+	uint16_t value;			// Conversion result
+} adc_sample;
+
+// FUNCTION DECLARATIONS //
+void adc_init(const adc_channel* channels, uint8_t count);
+
+void adc_start(void);
+
+bool adc_startTriggered(uint32_t rate);
+
+void adc_stop(void);
+
+bool adc_latest(uint8_t channel, adc_sample* sample);
+
+bool adc_read(adc_sample* sample);
+
+uint8_t adc_available(void);
+
+uint8_t adc_overruns(void);
+
+
+#endif /* ADC_H_ */
@@ -6,8 +6,13 @@
  *
  * This module initializes the I2C Bus as Master and provides functions for usage.
  *
- * FYI: This I2C Implementation is currently limited to Normal Mode (100kHz Speed),
- *      due to the CPU-Speeds required for faster rates.
+ * FYI: Normal Mode (100kHz), Fast Mode (400kHz) and Fast Mode Plus (1MHz) can be selected
+ *      in i2c_init(). The bus clock cannot exceed F_CPU / 10 and the Baud-Setting never
+ *      goes below the minimum SCL low time of the mode, so at F_CPU = 4MHz Fast Mode
+ *      runs at ~307kHz (T_LOW = 1.5us >= 1.3us) and Fast Mode Plus at 400kHz.
+ *
+ * All bus traffic is handled by a state machine in the TWI0 master interrupt,
+ * which works through a queue of pending transactions.
  *
  * *********************************************************************************
  *
@@ -24,31 +29,95 @@
 #include "AVR128DB48_I2C.h"
 #define F_CPU 4000000
 #include <util/delay.h>
+#include <util/atomic.h>
+#include <avr/interrupt.h>
 
 // DEFINES //
 #define I2C_WRITE		0		// Write Bit in Address
 #define I2C_READ		1		// Write Bit in Address
 
+#define QUEUE_MASK		(I2C_QUEUE_SIZE - 1)
+
+// Maximum rise time for SDA and SCL per mode in ns (I2C-Bus specification, adjust to the real bus if known) //
+#ifndef I2C_RISE_TIME_NORMAL_NS
+#define I2C_RISE_TIME_NORMAL_NS		1000
+#endif
+#ifndef I2C_RISE_TIME_FAST_NS
+#define I2C_RISE_TIME_FAST_NS		300
+#endif
+#ifndef I2C_RISE_TIME_FAST_PLUS_NS
+#define I2C_RISE_TIME_FAST_PLUS_NS	120
+#endif
+
+// Minimum SCL low time per mode in ns (I2C-Bus specification) //
+#define I2C_LOW_TIME_NORMAL_NS		4700
+#define I2C_LOW_TIME_FAST_NS		1300
+#define I2C_LOW_TIME_FAST_PLUS_NS	500
+
+// Baud-Setting (AVR128DB48 Data sheet -> Two-Wire Interface): f_SCL = F_CPU / (10 + 2 * BAUD + F_CPU * T_r) //
+#define I2C_BAUD_RAW(f_scl, t_rise_ns)	(((long)(F_CPU / (f_scl)) - 10L - (long)((F_CPU / 1000UL) * (t_rise_ns) / 1000000UL)) / 2L)
+// Smallest Baud-Setting whose SCL low time T_LOW = (BAUD + 5) / F_CPU meets the minimum //
+#define I2C_BAUD_LOW(t_low_ns)			((long)(((F_CPU / 1000UL) * (t_low_ns) + 999999UL) / 1000000UL) - 5L)
+#define I2C_BAUD_MIN(t_low_ns)			(I2C_BAUD_LOW(t_low_ns) < 0 ? 0L : I2C_BAUD_LOW(t_low_ns))
+// Clamp to the fastest rate that keeps T_LOW within the specification //
+#define I2C_BAUD(f_scl, t_rise_ns, t_low_ns)	(I2C_BAUD_RAW(f_scl, t_rise_ns) < I2C_BAUD_MIN(t_low_ns) ? (uint8_t)I2C_BAUD_MIN(t_low_ns) : (uint8_t)I2C_BAUD_RAW(f_scl, t_rise_ns))
+
+#define I2C_BAUD_NORMAL		I2C_BAUD(100000UL, I2C_RISE_TIME_NORMAL_NS, I2C_LOW_TIME_NORMAL_NS)
+#define I2C_BAUD_FAST		I2C_BAUD(400000UL, I2C_RISE_TIME_FAST_NS, I2C_LOW_TIME_FAST_NS)
+#define I2C_BAUD_FAST_PLUS	I2C_BAUD(1000000UL, I2C_RISE_TIME_FAST_PLUS_NS, I2C_LOW_TIME_FAST_PLUS_NS)
+
+// Resulting SCL frequency for a Baud-Setting //
+#define I2C_SCL(baud, t_rise_ns)	(F_CPU / (10UL + 2UL * (baud) + (F_CPU / 1000UL) * (t_rise_ns) / 1000000UL))
+
+#if (I2C_QUEUE_SIZE & QUEUE_MASK) != 0 || I2C_QUEUE_SIZE > 128
+#error "I2C_QUEUE_SIZE must be a power of two and not larger than 128"
+#endif
+
 // Variables //
-volatile i2c_status status;
+static i2c_transaction* volatile queue[I2C_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;		// Next free slot
+static volatile uint8_t queue_tail = 0;		// Transaction currently on the bus
+static volatile bool active = false;		// A transaction is on the bus
+static volatile uint8_t position = 0;		// Bytes transferred in the current transaction
+static uint32_t frequency = 0;				// SCL frequency selected in i2c_init()
 
 // PRIVATE FUNCTION DECLARATIONS //
-static void			wait_for_state_change(void);
-static i2c_status	check_errors(void);
+static void			start_next(void);
+static void			finish(i2c_status result);
+static void			service(void);
+static i2c_status	transfer(uint8_t address, bool read, uint8_t* data, uint8_t length);
 
 // PUBLIC FUNCTIONS //
 /*
-*	Initializes the I2C Bus in Normal Mode and this device as Master
+*	Initializes the I2C Bus in the given mode and this device as Master
+*	@param mode Bus speed (NORMAL_MODE, FAST_MODE or FAST_MODE_PLUS)
 *	@return None
 */
-void i2c_init(void) {
+void i2c_init(i2c_mode mode) {
 	
 	// I2C Configuration //
-	TWI0.CTRLA = TWI_SDAHOLD_50NS_gc;	// Set Holdtime to 50ns
+	switch (mode) {
+		case FAST_MODE:
+			TWI0.CTRLA = TWI_SDAHOLD_300NS_gc;					// Hold SDA past the undefined region of the falling SCL edge
+			TWI0.MBAUD = I2C_BAUD_FAST;
+			frequency = I2C_SCL(I2C_BAUD_FAST, I2C_RISE_TIME_FAST_NS);
+			break;
+		case FAST_MODE_PLUS:
+			TWI0.CTRLA = TWI_SDAHOLD_50NS_gc | TWI_FMPEN_bm;	// Short hold time (t_VD;DAT <= 450ns) and Fm+ drive strength
+			TWI0.MBAUD = I2C_BAUD_FAST_PLUS;
+			frequency = I2C_SCL(I2C_BAUD_FAST_PLUS, I2C_RISE_TIME_FAST_PLUS_NS);
+			break;
+		case NORMAL_MODE:
+		default:
+			TWI0.CTRLA = TWI_SDAHOLD_50NS_gc;					// Set Holdtime to 50ns
+			TWI0.MBAUD = I2C_BAUD_NORMAL;
+			frequency = I2C_SCL(I2C_BAUD_NORMAL, I2C_RISE_TIME_NORMAL_NS);
+			break;
+	}
 	
 	// Enable Run in Debug //
 	TWI0.DBGCTRL = TWI_DBGRUN_bm;
-																					
+																						
 	// Clear Master Status Register //
 	TWI0.MSTATUS = TWI_RIF_bm |				// Clear Read Interrupt Flag
 				   TWI_WIF_bm |				// Clear Write Interrupt Flag
@@ -59,15 +128,14 @@ void i2c_init(void) {
 				   TWI_BUSSTATE_IDLE_gc;	// Force Master into IDLE-Mode
 	
 	// Master Configuration //
-	TWI0.MBAUD = 15;		// Calculated Baud-Setting based on F_CPU = 4000000 and T_r (Rise time for both SDA and SCL, found in AVR128DB48 Data sheet -> Electrical Characteristics)
-							// Formula is found in AVR128DB48 Data sheet -> Two-Wire Interface
-							// Results in ~100kHz
-	
-	TWI0.MCTRLA = TWI_ENABLE_bm;	// Use this device as Master withput any Interrupts
+	TWI0.MCTRLA = TWI_ENABLE_bm |	// Use this device as Master
+				  TWI_RIEN_bm |		// with Read Interrupt
+				  TWI_WIEN_bm;		// and Write Interrupt
 }
 
 /*
 *	Writes data to the specified device address.
+*	Waits until the transaction has been processed.
 *
 *	@param address Address of the target device
 *	@param data Data as Byte-Array to be send
@@ -75,40 +143,7 @@ void i2c_init(void) {
 *	@return i2c_status Status code after execution
 */
 i2c_status i2c_write(uint8_t address, uint8_t* data, uint8_t length) {
-	
-	// Check if Master is not in idle //
-	if((TWI0.MSTATUS & TWI_BUSSTATE_IDLE_gc) != TWI_BUSSTATE_IDLE_gc)
-		return ERROR_NOT_READY;
-	
-	// Transmit Address //
-	TWI0.MADDR = (address << 1) | I2C_WRITE;	// Start write operation by writing the address to the MADDR register, 
-												// initiating the transmission
-	
-	// Wait for change in bus state //
-	wait_for_state_change();
-	
-	// Check any bus errors //
-	check_errors();
-
-	// Transmit Data //
-	uint8_t pos = 0;
-	while(pos < length) {
-		
-		TWI0.MDATA = data[pos++];
-		
-		wait_for_state_change();
-		
-		// Check for NACK //
-		if(TWI0.MSTATUS & TWI_RXACK_bm) {
-			TWI0.MCTRLB = TWI_MCMD_STOP_gc;		// -> Stop transmission
-			return NACK;
-		}
-	}
-	
-	// Stop Transmission //
-	TWI0.MCTRLB = TWI_MCMD_STOP_gc;
-	
-	return SUCCESS;
+	return transfer(address, false, data, length);
 }
 
 /*
@@ -120,42 +155,12 @@ i2c_status i2c_write(uint8_t address, uint8_t* data, uint8_t length) {
 *	@return i2c_status Status code after execution
 */
 i2c_status i2c_write_byte(uint8_t address, uint8_t data) {
-
-	// Check if Master is not in idle //
-	if((TWI0.MSTATUS & TWI_BUSSTATE_IDLE_gc) != TWI_BUSSTATE_IDLE_gc)
-		return ERROR_NOT_READY;
-	
-	// Transmit Address //
-	TWI0.MADDR = (address << 1) | I2C_WRITE;	// Start write operation by writing the address to the MADDR register,
-												// initiating the transmission
-	
-	// Wait for change in bus state //
-	wait_for_state_change();
-	
-	// Check any bus errors //
-	status = check_errors();
-	if(status != SUCCESS)
-		return status;
-	
-	// Transmit Data //
-	TWI0.MDATA = data;
-		
-	// Wait for change in bus state //
-	wait_for_state_change();
-	
-	// Check any bus errors //
-	status = check_errors();
-	if(status != SUCCESS)
-		return status;
-	
-	// Stop Transmission //
-	TWI0.MCTRLB = TWI_MCMD_STOP_gc;
-	
-	return SUCCESS;	
+	return transfer(address, false, &data, 1);
 }
 
 /*
 *	Read data from the specified device address.
+*	Waits until the transaction has been processed.
 *
 *	@param address Address of the target device
 *	@param data Byte-Array to save read data
@@ -163,45 +168,7 @@ i2c_status i2c_write_byte(uint8_t address, uint8_t data) {
 *	@return i2c_status Status code after execution
 */
 i2c_status i2c_read(uint8_t address, uint8_t* data, uint8_t length) {
-
-	// Check if Master is not in idle //
-	if((TWI0.MSTATUS & TWI_BUSSTATE_IDLE_gc) != TWI_BUSSTATE_IDLE_gc)
-		return ERROR_NOT_READY;
-	
-	// Transmit Address //
-	TWI0.MADDR = (address << 1) + I2C_READ;		// Start read operation by writing the address to the MADDR register,
-												// initiating the transmission
-	
-	// Wait for change in bus state //
-	wait_for_state_change();
-	
-	// Check any bus errors //
-	status = check_errors();
-	if(status != SUCCESS)
-		return status;
-	
-	// Release Clock //
-	TWI0.MSTATUS = TWI_CLKHOLD_bm;
-		
-	uint8_t pos = 0;
-	while (pos < length)
-	{
-		// Wait until data is received //
-		wait_for_state_change();
-		
-		// Store incoming byte //
-		data[pos++] = TWI0.MDATA;
-		
-		// Send ACK and get ready to read next byte, if transmission is still ongoing //
-		if (pos != length) {
-			TWI0.MCTRLB = TWI_ACKACT_ACK_gc | TWI_MCMD_RECVTRANS_gc;
-		}
-	}
-	
-	// Finish transmission with NACK and stop it //
-	TWI0.MCTRLB = TWI_ACKACT_NACK_gc | TWI_MCMD_STOP_gc;
-		
-	return SUCCESS;		
+	return transfer(address, true, data, length);
 }
 
 /*
@@ -212,66 +179,181 @@ i2c_status i2c_read(uint8_t address, uint8_t* data, uint8_t length) {
 *	@return i2c_status Status code after execution
 */
 i2c_status i2c_read_byte(uint8_t address, uint8_t* data) {
+	return transfer(address, true, data, 1);
+}
+
+/*
+*	Queues a transaction without waiting for it.
+*	The transaction and its data buffer must stay untouched until transaction->done is set.
+*	The callback (if any) is executed in interrupt context.
+*
+*	@param transaction Transaction to be processed
+*	@return i2c_status SUCCESS if queued, ERROR_NOT_READY if the queue is full,
+*			ERROR if a read of zero bytes was requested
+*/
+i2c_status i2c_submit(i2c_transaction* transaction) {
 	
-	// Check if Master is not in idle //
-	if((TWI0.MSTATUS & TWI_BUSSTATE_IDLE_gc) != TWI_BUSSTATE_IDLE_gc)
-		return ERROR_NOT_READY;
-	
-	// Transmit Address //
-	TWI0.MADDR = (address << 1) | I2C_READ;	// Start write operation by writing the address to the MADDR register,
-	// initiating the transmission
+	if (transaction->read && transaction->length == 0)
+		return ERROR;
 	
-	// Wait for change in bus state //
-	wait_for_state_change();
+	transaction->done = false;
+	transaction->status = SUCCESS;
 	
-	// Check any bus errors //
-	status = check_errors();
-	if(status != SUCCESS)
-		return status;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		uint8_t next = (queue_head + 1) & QUEUE_MASK;
+		if (next == queue_tail)
+			return ERROR_NOT_READY;
+		
+		queue[queue_head] = transaction;
+		queue_head = next;
+		
+		if (!active)
+			start_next();
+	}
 	
-	// Release Clock //
-	TWI0.MSTATUS = TWI_CLKHOLD_bm;
+	return SUCCESS;
+}
+
+/*
+*	Waits until the given transaction has finished.
+*	If global interrupts are disabled the bus is serviced by polling.
+*
+*	@param transaction Previously submitted transaction
+*	@return None
+*/
+void i2c_wait(i2c_transaction* transaction) {
+	while (!transaction->done) {
+		if (!(SREG & CPU_I_bm))
+			service();
+	}
+}
+
+/*
+*	@return bool true while any transaction is pending or on the bus
+*/
+bool i2c_busy(void) {
+	return active;
+}
+
+/*
+*	@return uint32_t SCL frequency in Hz selected by i2c_init() (0 before initialization)
+*/
+uint32_t i2c_frequency(void) {
+	return frequency;
+}
+
+// PRIVATE FUNCTIONS //
+static i2c_status transfer(uint8_t address, bool read, uint8_t* data, uint8_t length) {
+	
+	i2c_transaction transaction = {
+		.address = address,
+		.read = read,
+		.data = data,
+		.length = length,
+		.callback = NULL
+	};
+	
+	// Wait for a free slot in the queue //
+	i2c_status result;
+	while ((result = i2c_submit(&transaction)) == ERROR_NOT_READY) {
+		if (!(SREG & CPU_I_bm))
+			service();
+	}
+	if (result != SUCCESS)
+		return result;
 	
-	// Wait until data is received //
-	wait_for_state_change();
+	i2c_wait(&transaction);
 	
-	// Read Data //
-	data[0] = TWI0.MDATA;
+	return transaction.status;
+}
+
+// Puts the oldest queued transaction on the bus (called with interrupts disabled) //
+static void start_next(void) {
 	
-    //NACK and STOP the bus
-    TWI0.MCTRLB = TWI_ACKACT_NACK_gc | TWI_MCMD_STOP_gc;
+	if (queue_tail == queue_head) {
+		active = false;
+		return;
+	}
+	active = true;
+	position = 0;
 	
-	return SUCCESS;
+	i2c_transaction* current = queue[queue_tail];
+	TWI0.MADDR = (current->address << 1) | (current->read ? I2C_READ : I2C_WRITE);	// Writing the address initiates the transmission
 }
 
-// PRIVATE FUNCTIONS //
-static void wait_for_state_change(void) {
-	// Wait for completion of address transmission / for an error //	// Wait until one state is true:
-	while (!((TWI0.MSTATUS & TWI_CLKHOLD_bm) ||							// Clockhold is active	(Transmission was successful)
-	(TWI0.MSTATUS & TWI_BUSERR_bm)   ||									// A bus error occured
-	(TWI0.MSTATUS & TWI_ARBLOST_bm)  ||									// Arbitration is lost
-	((TWI0.MSTATUS & TWI_BUSSTATE_BUSY_gc) == TWI_BUSSTATE_BUSY_gc))	// Bus switches to busy
-	);
+// Completes the current transaction and starts the next one //
+static void finish(i2c_status result) {
+	
+	i2c_transaction* current = queue[queue_tail];
+	queue_tail = (queue_tail + 1) & QUEUE_MASK;
+	
+	current->status = result;
+	current->done = true;
+	if (current->callback != NULL)
+		current->callback(current);
+	
+	start_next();
 }
 
-static i2c_status check_errors(void) {
-	// Check for errors //
-	if(TWI0.MSTATUS & TWI_RXACK_bp) {											// Check for NACK
-		TWI0.MCTRLB = TWI_MCMD_STOP_gc;											// -> Stop transmission
-		return NACK;
-	}
-	if(TWI0.MSTATUS & TWI_ARBLOST_bm) {											// Check for arbitration lost
-		TWI0.MCTRLB = TWI_MCMD_STOP_gc;											// -> Stop transmission
-		return ARBITRATION_LOST;
+// Master state machine, advanced on each read / write interrupt //
+static void service(void) {
+	
+	uint8_t mstatus = TWI0.MSTATUS;
+	
+	if (!active || !(mstatus & (TWI_RIF_bm | TWI_WIF_bm)))
+		return;
+	
+	i2c_transaction* current = queue[queue_tail];
+	
+	// Check any bus errors //
+	if (mstatus & TWI_ARBLOST_bm) {
+		TWI0.MSTATUS = TWI_ARBLOST_bm | TWI_WIF_bm | TWI_RIF_bm;
+		TWI0.MCTRLB = TWI_MCMD_STOP_gc;
+		finish(ARBITRATION_LOST);
+		return;
 	}
-	if(TWI0.MSTATUS & TWI_BUSERR_bm) {											// Check for bus error
-		TWI0.MCTRLB = TWI_MCMD_STOP_gc;											// -> Stop transmission
-		return ERROR;
+	if (mstatus & TWI_BUSERR_bm) {
+		TWI0.MSTATUS = TWI_BUSERR_bm | TWI_WIF_bm | TWI_RIF_bm;
+		TWI0.MCTRLB = TWI_MCMD_STOP_gc;
+		finish(ERROR);
+		return;
 	}
-	if((TWI0.MSTATUS & TWI_BUSSTATE_BUSY_gc) == TWI_BUSSTATE_BUSY_gc) {			// Check if bus is busy
-		TWI0.MCTRLB = TWI_MCMD_STOP_gc;											// -> Stop transmission
-		return ERROR_NOT_READY;
+	
+	// Read: a data byte was received //
+	if (mstatus & TWI_RIF_bm) {
+		current->data[position++] = TWI0.MDATA;
+		
+		if (position < current->length) {
+			TWI0.MCTRLB = TWI_ACKACT_ACK_gc | TWI_MCMD_RECVTRANS_gc;	// ACK and read next byte
+		}
+		else {
+			TWI0.MCTRLB = TWI_ACKACT_NACK_gc | TWI_MCMD_STOP_gc;		// Finish transmission with NACK and stop it
+			finish(SUCCESS);
+		}
+		return;
 	}
 	
-	return SUCCESS;
+	// Write: address or data byte was sent //
+	if (mstatus & TWI_RXACK_bm) {
+		TWI0.MCTRLB = TWI_MCMD_STOP_gc;		// NACK -> Stop transmission
+		finish(NACK);
+		return;
+	}
+	if (current->read) {					// Address of a read was acknowledged but no data is pending
+		TWI0.MCTRLB = TWI_MCMD_STOP_gc;
+		finish(ERROR);
+		return;
+	}
+	if (position < current->length) {
+		TWI0.MDATA = current->data[position++];
+	}
+	else {
+		TWI0.MCTRLB = TWI_MCMD_STOP_gc;		// Stop Transmission
+		finish(SUCCESS);
+	}
+}
+
+// INTERRUPTS //
+ISR(TWI0_TWIM_vect) {
+	service();
 }
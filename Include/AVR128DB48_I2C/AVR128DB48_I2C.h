@@ -6,8 +6,14 @@
  *
  * This module initializes the I2C Bus as Master and provides functions for usage.
  *
- * FYI: This I2C Implementation is currently limited to Normal Mode (100kHz Speed),
- *      due to the CPU-Speeds required for faster rates.
+ * FYI: Normal Mode (100kHz), Fast Mode (400kHz) and Fast Mode Plus (1MHz) can be selected
+ *      in i2c_init(). The bus clock cannot exceed F_CPU / 10 and the Baud-Setting never
+ *      goes below the minimum SCL low time of the mode, so at F_CPU = 4MHz Fast Mode
+ *      runs at ~307kHz (T_LOW = 1.5us >= 1.3us) and Fast Mode Plus at 400kHz.
+ *
+ * The bus is driven by the TWI0 master interrupt. Transactions are queued and
+ * processed one after another; each one reports its result through a poll flag
+ * and an optional completion callback.
  *
  * *********************************************************************************
  *
@@ -25,6 +31,9 @@
   
   1. Call i2c_init() before using any other function.                                                  
   2. Use i2c_read() or i2c_write() for transmitting and receiving data.
+     These submit a transaction and wait for its completion.
+  3. Use i2c_submit() to queue a transaction without waiting. The transaction and
+     its data buffer must stay valid until its done flag is set.
 */
 
 
@@ -33,6 +42,13 @@
 
 // INCLUDES //
 #include <avr/io.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DEFINES //
+#ifndef I2C_QUEUE_SIZE
+#define I2C_QUEUE_SIZE	8		// Number of transactions that can be pending (power of two)
+#endif
 
 
 // ENUMS //
@@ -44,17 +60,28 @@ typedef enum {
 	ARBITRATION_LOST	// Arbitration was lost during transmission
 } i2c_status;
 
-/*
 typedef enum {
 	NORMAL_MODE,	// Bus operating at 100kHz
 	FAST_MODE,		// Bus operating at 400kHz
 	FAST_MODE_PLUS	// Bus operating at 1MHz
 } i2c_mode;
-*/
+
+// TYPES //
+struct i2c_transaction;
+typedef void (*i2c_callback)(struct i2c_transaction* transaction);
+
+typedef struct i2c_transaction {
+	uint8_t address;				// 7-Bit address of the target device
+	bool read;						// true: read from the device; false: write to the device
+	uint8_t* data;					// Data to be send / storage for received data
+	uint8_t length;					// Number of bytes to transfer
+	i2c_callback callback;			// Called from the TWI interrupt on completion (may be NULL)
+	volatile bool done;				// Set once the transaction has finished
+	volatile i2c_status status;		// Result of the transaction, valid once done is set
+} i2c_transaction;
 
 // FUNCTION DECLARATIONS //
-//void i2c_init(i2c_mode mode);
-void i2c_init(void);
+void i2c_init(i2c_mode mode);
 
 i2c_status i2c_write(uint8_t address, uint8_t* data, uint8_t length);
 
@@ -64,5 +91,13 @@ i2c_status i2c_read(uint8_t address, uint8_t* data, uint8_t length);
 
 i2c_status i2c_read_byte(uint8_t address, uint8_t* data);
 
+i2c_status i2c_submit(i2c_transaction* transaction);
+
+void i2c_wait(i2c_transaction* transaction);
+
+bool i2c_busy(void);
+
+uint32_t i2c_frequency(void);
+
 
 #endif /* ARV128DB48_I2C_H_ */
@@ -0,0 +1,190 @@
+/*
+ ***********************************************************************************
+ * @file:   Buttons.c
+ * @date:   17.10.2026
+ *
+ * Pin change interrupt of PORTC (or RTC periodic interrupt with vertical counter
+ * debouncing) feeding a ring buffer of timestamped events.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Buttons.h"
+#include "RTC.h"
+#include <avr/interrupt.h>
+
+// DEFINES //
+#define QUEUE_MASK		(BUTTONS_QUEUE_SIZE - 1)
+
+#if (BUTTONS_QUEUE_SIZE & QUEUE_MASK) != 0 || BUTTONS_QUEUE_SIZE > 128
+#error "BUTTONS_QUEUE_SIZE must be a power of two and not larger than 128"
+#endif
+
+// Variables //
+static volatile button_event queue[BUTTONS_QUEUE_SIZE];
+static volatile uint8_t head = 0;			// Next free slot, only written by the PORTC interrupt
+static volatile uint8_t tail = 0;			// Oldest unread event, only written by the main program
+static volatile uint8_t dropped = 0;		// Events lost because the ring buffer was full
+
+static uint8_t debounce_pins = 0;			// Pins sampled by the PIT interrupt
+static uint8_t state = 0;					// Debounced state, 1 = pressed (pin low)
+static uint8_t count0 = 0xFF;				// Vertical counter, bit 0 of each pin
+static uint8_t count1 = 0xFF;				// Vertical counter, bit 1 of each pin
+static uint16_t hold[8];					// Samples each pressed pin has been held
+
+// PRIVATE FUNCTION DECLARATIONS //
+static uint8_t enqueue(uint8_t position, uint8_t pin, uint8_t edge, uint16_t timestamp);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Configures the given pins of PORTC as inputs with pull-up and interrupt on both edges
+*	and starts the RTC as timestamp source.
+*
+*	@param pins Bit mask of the pins, e.g. PIN4_bm | PIN5_bm
+*	@return None
+*/
+void buttons_init(uint8_t pins) {
+	
+	rtc_init();
+	
+	PORTC.DIRCLR = pins;
+	for (uint8_t pin = 0; pin < 8; pin++) {
+		if (pins & (1 << pin))
+			(&PORTC.PIN0CTRL)[pin] = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
+	}
+	PORTC.INTFLAGS = pins;		// Forget changes from before the configuration
+}
+
+/*
+*	Configures the given pins of PORTC as inputs with pull-up (without pin change interrupt)
+*	and starts the RTC periodic interrupt that samples and debounces them every BUTTONS_TICK.
+*
+*	@param pins Bit mask of the pins, e.g. PIN4_bm | PIN5_bm
+*	@return None
+*/
+void buttons_initDebounced(uint8_t pins) {
+	
+	rtc_init();
+	
+	PORTC.DIRCLR = pins;
+	for (uint8_t pin = 0; pin < 8; pin++) {
+		if (pins & (1 << pin))
+			(&PORTC.PIN0CTRL)[pin] = PORT_PULLUPEN_bm | PORT_ISC_INTDISABLE_gc;
+	}
+	debounce_pins = pins;
+	
+	while (RTC.PITSTATUS > 0);						// Wait until PITCTRLA is synchronized
+	RTC.PITINTCTRL = RTC_PI_bm;
+	RTC.PITCTRLA = BUTTONS_TICK | RTC_PITEN_bm;
+}
+
+/*
+*	Removes up to max events from the ring buffer, oldest first.
+*	@param events Storage for max events
+*	@param max Largest number of events to be copied
+*	@return uint8_t Number of events copied
+*/
+uint8_t buttons_read(button_event* events, uint8_t max) {
+	
+	uint8_t position = tail;
+	uint8_t end = head;
+	uint8_t count = 0;
+	
+	while (position != end && count < max) {
+		events[count].timestamp = queue[position].timestamp;
+		events[count].pin = queue[position].pin;
+		events[count].edge = queue[position].edge;
+		position = (position + 1) & QUEUE_MASK;
+		count++;
+	}
+	tail = position;		// Release all copied slots at once
+	
+	return count;
+}
+
+/*
+*	@return bool true if at least one event is waiting
+*/
+bool buttons_pending(void) {
+	return tail != head;
+}
+
+/*
+*	@return uint8_t Number of events lost because the ring buffer was full
+*/
+uint8_t buttons_dropped(void) {
+	return dropped;
+}
+
+// PRIVATE FUNCTIONS //
+/*
+*	Stores an event at position, called from the interrupts only.
+*	@return uint8_t Next free position (unchanged if the ring buffer is full)
+*/
+static uint8_t enqueue(uint8_t position, uint8_t pin, uint8_t edge, uint16_t timestamp) {
+	
+	uint8_t next = (position + 1) & QUEUE_MASK;
+	if (next == tail) {
+		dropped++;
+		return position;
+	}
+	queue[position].timestamp = timestamp;
+	queue[position].pin = pin;
+	queue[position].edge = edge;
+	return next;
+}
+
+// INTERRUPTS //
+ISR(PORTC_PORT_vect) {
+	
+	uint8_t flags = PORTC.INTFLAGS;
+	PORTC.INTFLAGS = flags;			// Clear exactly the changes handled here
+	uint8_t level = PORTC.IN;
+	uint16_t timestamp = RTC.CNT;
+	uint8_t position = head;
+	
+	for (uint8_t pin = 0; flags != 0; pin++, flags >>= 1) {
+		if (flags & 1)
+			position = enqueue(position, pin, (level & (1 << pin)) ? BUTTON_RISING : BUTTON_FALLING, timestamp);
+	}
+	head = position;
+}
+
+ISR(RTC_PIT_vect) {
+	
+	RTC.PITINTFLAGS = RTC_PI_bm;
+	
+	// Vertical counter: every pin whose sample differs from the debounced state counts
+	// down from 3, any equal sample resets it. After four differing samples in a row
+	// the state toggles.
+	uint8_t changed = (state ^ (uint8_t)~PORTC.IN) & debounce_pins;
+	count0 = ~(count0 & changed);
+	count1 = count0 ^ (count1 & changed);
+	changed &= count0 & count1;
+	state ^= changed;
+	
+	if ((state | changed) == 0)
+		return;						// All released and nothing happened: the common case
+	
+	uint16_t timestamp = RTC.CNT;
+	uint8_t position = head;
+	
+	for (uint8_t pin = 0; pin < 8; pin++) {
+		uint8_t mask = 1 << pin;
+		if (changed & mask) {
+			hold[pin] = 0;
+			position = enqueue(position, pin, (state & mask) ? BUTTON_PRESSED : BUTTON_RELEASED, timestamp);
+		}
+		else if ((state & mask) && hold[pin] < BUTTONS_LONG_TICKS) {
+			if (++hold[pin] == BUTTONS_LONG_TICKS)
+				position = enqueue(position, pin, BUTTON_LONG_PRESS, timestamp);
+		}
+	}
+	head = position;
+}
@@ -0,0 +1,91 @@
+/*
+ ***********************************************************************************
+ * @file:   Buttons.h
+ * @date:   17.10.2026
+ *
+ * Buttons on PORTC as a queue of timestamped events. The pin change interrupt reads
+ * INTFLAGS and IN once, clears the flags it has seen and appends one event per changed
+ * pin to a single-producer / single-consumer ring buffer, so the order of the edges is
+ * kept however many arrive before the main program looks at them.
+ *
+ * For mechanical contacts there is a debounced mode instead: the RTC periodic interrupt
+ * samples PORTC.IN every BUTTONS_TICK and debounces all eight pins at once with vertical
+ * counters (two bits per pin in two bytes). A pin has to read the same level on four
+ * consecutive samples before its state changes, so a bouncing contact produces exactly
+ * one press and one release and no pin change interrupts at all.
+ *
+ * Timestamps are taken from the RTC counter (internal 32.768kHz oscillator,
+ * 1 tick = 30.5us, wraps every 2s), the same time base as the ADC module.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  1. Call buttons_init() with the pins (e.g. PIN4_bm | PIN5_bm | PIN6_bm | PIN7_bm) and
+     enable global interrupts (sei()). The pins become inputs with pull-up; the module
+     owns ISR(PORTC_PORT_vect).
+  2. Drain the events in batches with buttons_read(). The edge is derived from the level
+     read in the interrupt: two changes of one pin before the interrupt runs show up as
+     one event with the current level.
+
+  Debounced mode: call buttons_initDebounced() instead of buttons_init(). The buttons are
+  expected between pin and GND (active low, pull-ups on). Events are BUTTON_PRESSED,
+  BUTTON_RELEASED and BUTTON_LONG_PRESS (once per press after BUTTONS_LONG_TICKS samples);
+  the module owns ISR(RTC_PIT_vect). The PIT keeps running in standby, so the main program
+  can sleep between events. Only one of the two modes can be used in a program.
+*/
+
+
+#ifndef BUTTONS_H_
+#define BUTTONS_H_
+
+// INCLUDES //
+#include <avr/io.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINES //
+#ifndef BUTTONS_QUEUE_SIZE
+#define BUTTONS_QUEUE_SIZE	16		// Number of events in the ring buffer (power of two, max. 128)
+#endif
+
+#ifndef BUTTONS_TICK
+#define BUTTONS_TICK		RTC_PERIOD_CYC128_gc	// Sampling period of the debounced mode (3.9ms, 4 samples = 15.6ms)
+#endif
+
+#ifndef BUTTONS_LONG_TICKS
+#define BUTTONS_LONG_TICKS	256		// Samples a button has to be held for BUTTON_LONG_PRESS (1s)
+#endif
+
+// ENUMS //
+typedef enum {
+	BUTTON_FALLING,			// Pin changed to low
+	BUTTON_RISING,			// Pin changed to high
+	BUTTON_PRESSED,			// Debounced: pin stable low
+	BUTTON_RELEASED,		// Debounced: pin stable high again
+	BUTTON_LONG_PRESS		// Debounced: pin held low for BUTTONS_LONG_TICKS samples
+} button_edge;
+
+// TYPES //
+typedef struct {
+	uint16_t timestamp;		// RTC ticks when the interrupt saw the change (the debounced state)
+	uint8_t pin;			// Pin number 0..7 of PORTC
+	uint8_t edge;			// button_edge
+} button_event;
+
+// FUNCTION DECLARATIONS //
+void buttons_init(uint8_t pins);
+
+void buttons_initDebounced(uint8_t pins);
+
+uint8_t buttons_read(button_event* events, uint8_t max);
+
+bool buttons_pending(void);
+
+uint8_t buttons_dropped(void);
+
+
+#endif /* BUTTONS_H_ */
@@ -0,0 +1,155 @@
+/*
+ ***********************************************************************************
+ * @file:   Calibration.c
+ * @date:   17.10.2026
+ *
+ * Learned min/max calibration with a versioned, CRC protected EEPROM record.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Calibration.h"
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include <stddef.h>
+
+// DEFINES //
+#define RECORD_MAGIC	0xCA		// Marks a written record (erased EEPROM reads 0xFF)
+#define EMPTY_MIN		0xFFFF		// min/max of an empty calibration: the first sample sets both
+#define EMPTY_MAX		0
+
+// TYPES //
+typedef struct {
+	uint8_t magic;			// RECORD_MAGIC
+	uint8_t version;		// CALIBRATION_VERSION
+	uint16_t min;
+	uint16_t max;
+	uint16_t crc;			// CRC16 of the bytes before
+} calibration_record;
+
+// Variables //
+static calibration_record EEMEM record;
+static calibration stored = { EMPTY_MIN, EMPTY_MAX };	// Copy of the EEPROM record, saves reading it back
+static bool stored_valid = false;
+
+// PRIVATE FUNCTION DECLARATIONS //
+static uint16_t record_crc(const calibration_record* data);
+static uint16_t distance(uint16_t a, uint16_t b);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Reads the calibration from the EEPROM.
+*	@param cal Receives the stored calibration, or an empty one
+*	@return bool true if a valid record of this version was found
+*/
+bool calibration_load(calibration* cal) {
+
+	calibration_record data;
+	eeprom_read_block(&data, &record, sizeof(data));
+
+	stored_valid = data.magic == RECORD_MAGIC && data.version == CALIBRATION_VERSION
+		&& data.crc == record_crc(&data) && data.min <= data.max;
+
+	if (stored_valid) {
+		stored.min = data.min;
+		stored.max = data.max;
+		*cal = stored;
+	}
+	else {
+		cal->min = EMPTY_MIN;
+		cal->max = EMPTY_MAX;
+	}
+
+	return stored_valid;
+}
+
+/*
+*	Widens the calibration to include a sample.
+*	@param cal Calibration in RAM
+*	@param value Raw sample
+*	@return bool true if min or max changed (factors derived from the span need an update)
+*/
+bool calibration_learn(calibration* cal, uint16_t value) {
+
+	bool changed = false;
+	if (value < cal->min) {
+		cal->min = value;
+		changed = true;
+	}
+	if (value > cal->max) {
+		cal->max = value;
+		changed = true;
+	}
+	return changed;
+}
+
+/*
+*	@param cal Calibration in RAM
+*	@return bool true if max - min is at least CALIBRATION_MIN_SPAN
+*/
+bool calibration_valid(const calibration* cal) {
+	return cal->max >= cal->min && cal->max - cal->min >= CALIBRATION_MIN_SPAN;
+}
+
+/*
+*	Writes the calibration to the EEPROM if it is valid and min or max moved by at least
+*	CALIBRATION_THRESHOLD since the last write (or nothing was stored yet).
+*	@param cal Calibration in RAM
+*	@return bool true if the record was written
+*/
+bool calibration_save(const calibration* cal) {
+
+	if (!calibration_valid(cal))
+		return false;
+	if (stored_valid && distance(cal->min, stored.min) < CALIBRATION_THRESHOLD
+		&& distance(cal->max, stored.max) < CALIBRATION_THRESHOLD)
+		return false;
+
+	calibration_record data = {
+		.magic = RECORD_MAGIC,
+		.version = CALIBRATION_VERSION,
+		.min = cal->min,
+		.max = cal->max
+	};
+	data.crc = record_crc(&data);
+	eeprom_update_block(&data, &record, sizeof(data));
+
+	stored = *cal;
+	stored_valid = true;
+	return true;
+}
+
+/*
+*	Invalidates the EEPROM record (one byte write) and empties the calibration.
+*	@param cal Calibration in RAM
+*	@return None
+*/
+void calibration_erase(calibration* cal) {
+
+	eeprom_update_byte(&record.magic, 0xFF);		// Writes nothing if already erased
+	stored_valid = false;
+
+	cal->min = EMPTY_MIN;
+	cal->max = EMPTY_MAX;
+}
+
+// PRIVATE FUNCTIONS //
+// CRC16 (XMODEM) over the record without its crc field //
+static uint16_t record_crc(const calibration_record* data) {
+
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint16_t crc = 0;
+	for (uint8_t pos = 0; pos < offsetof(calibration_record, crc); pos++)
+		crc = _crc_xmodem_update(crc, bytes[pos]);
+	return crc;
+}
+
+static uint16_t distance(uint16_t a, uint16_t b) {
+	return a > b ? a - b : b - a;
+}
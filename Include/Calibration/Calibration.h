@@ -0,0 +1,69 @@
+/*
+ ***********************************************************************************
+ * @file:   Calibration.h
+ * @date:   17.10.2026
+ *
+ * Two-point calibration (raw value for 0 % and for 100 %) of a sensor, learned from
+ * the samples and kept in the EEPROM, so a node shows correct values from the first
+ * sample after a reset instead of calibrating again after every power cycle.
+ *
+ * The EEPROM holds one record: magic, layout version, min, max and a CRC16 (XMODEM).
+ * A record with a different magic or version or a wrong CRC (never written, written
+ * by an older firmware, interrupted write) is ignored. To limit wear the record is only
+ * written when min or max moved by at least CALIBRATION_THRESHOLD since the last write,
+ * and eeprom_update_block() skips the bytes that did not change. A write blocks for
+ * the EEPROM programming time of the changed bytes.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  1. Call calibration_load() once at start. It returns false if there was no valid
+     record; the calibration then starts empty.
+  2. Pass every (filtered) sample to calibration_learn() and call calibration_save()
+     now and then (e.g. once per display update).
+  3. calibration_valid() tells whether min and max are far enough apart to compute
+     a share; calibration_erase() forgets the calibration, also in the EEPROM.
+*/
+
+
+#ifndef CALIBRATION_H_
+#define CALIBRATION_H_
+
+// INCLUDES //
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINES //
+#define CALIBRATION_VERSION		1		// Layout of the EEPROM record, increment on changes
+
+#ifndef CALIBRATION_THRESHOLD
+#define CALIBRATION_THRESHOLD	32		// Change of min or max (raw LSB) that is worth an EEPROM write
+#endif
+
+#ifndef CALIBRATION_MIN_SPAN
+#define CALIBRATION_MIN_SPAN	64		// Smallest max - min that gives a meaningful share
+#endif
+
+// TYPES //
+typedef struct {
+	uint16_t min;			// Raw value for 0 % (0xFFFF: nothing learned yet)
+	uint16_t max;			// Raw value for 100 %
+} calibration;
+
+// FUNCTION DECLARATIONS //
+bool calibration_load(calibration* cal);
+
+bool calibration_learn(calibration* cal, uint16_t value);
+
+bool calibration_valid(const calibration* cal);
+
+bool calibration_save(const calibration* cal);
+
+void calibration_erase(calibration* cal);
+
+
+#endif /* CALIBRATION_H_ */
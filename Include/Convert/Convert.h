@@ -0,0 +1,108 @@
+/*
+ ***********************************************************************************
+ * @file:   Convert.h
+ * @date:   17.10.2026
+ *
+ * Fixed-point conversion of 12-Bit ADC results without floating point and without
+ * a division per sample.
+ *
+ * value * scale / full_scale is computed as (value * factor + 2^(shift - 1)) >> shift
+ * with the reciprocal factor = scale * 2^shift / full_scale. Constant factors are
+ * folded by the compiler; a factor for a calibrated full scale is computed once with
+ * convert_calibration(). Each kernel uses the largest shift for which value * factor
+ * still fits into 32 Bit. The results equal round(value * scale / full_scale) for every
+ * input 0..4095 (calibrated: 0..full_scale, any full scale). Host/Test/test_convert.c checks
+ * this exhaustively; convert_millivolt() is exact for CONVERT_REF_MV = 1024, 2048 and 3300 but not
+ * for every reference (2500: two inputs off by one) - add a new reference to the test first.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Set CONVERT_REF_MV to the reference voltage of the channel before including this header
+  (default: VDD = 3300mV; must not exceed 4095mV).
+*/
+
+
+#ifndef CONVERT_H_
+#define CONVERT_H_
+
+// INCLUDES //
+#include <stdint.h>
+
+// DEFINES //
+#ifndef CONVERT_REF_MV
+#define CONVERT_REF_MV			3300	// Reference voltage in mV
+#endif
+
+#define CONVERT_FULL_SCALE		4095UL	// Highest 12-Bit result
+
+#define CONVERT_MV_SHIFT		20		// 4095 * (4095mV * 2^20 / 4095) < 2^32
+#define CONVERT_RATIO_SHIFT		22		// 4095 * (1000 * 2^22 / 4095) < 2^32
+#define CONVERT_CAL_SHIFT		25		// value <= full_scale: value * (100 * 2^25 / full_scale) < 2^32
+
+// Reciprocal multiplier for value * scale / CONVERT_FULL_SCALE, rounded to nearest //
+#define CONVERT_FACTOR(scale, shift)	((uint32_t)((((uint64_t)(scale) << (shift)) + CONVERT_FULL_SCALE / 2) / CONVERT_FULL_SCALE))
+
+#if CONVERT_REF_MV > 4095
+#error "CONVERT_REF_MV must not exceed 4095mV"
+#endif
+
+// FUNCTIONS //
+// Multiplies with a reciprocal and rounds: (value * factor + 0.5) >> shift //
+static inline uint16_t convert_scale(uint16_t value, uint32_t factor, uint8_t shift) {
+	return (uint16_t)(((uint32_t)value * factor + (1UL << (shift - 1))) >> shift);
+}
+
+/*
+*	@param raw 12-Bit ADC result
+*	@return uint16_t Voltage in mV relative to CONVERT_REF_MV
+*/
+static inline uint16_t convert_millivolt(uint16_t raw) {
+	return convert_scale(raw, CONVERT_FACTOR(CONVERT_REF_MV, CONVERT_MV_SHIFT), CONVERT_MV_SHIFT);
+}
+
+/*
+*	@param raw 12-Bit ADC result
+*	@return uint16_t Share of the full scale in % (0..100)
+*/
+static inline uint16_t convert_percent(uint16_t raw) {
+	return convert_scale(raw, CONVERT_FACTOR(100, CONVERT_RATIO_SHIFT), CONVERT_RATIO_SHIFT);
+}
+
+/*
+*	@param raw 12-Bit ADC result
+*	@return uint16_t Share of the full scale in 0.1 % (0..1000)
+*/
+static inline uint16_t convert_permille(uint16_t raw) {
+	return convert_scale(raw, CONVERT_FACTOR(1000, CONVERT_RATIO_SHIFT), CONVERT_RATIO_SHIFT);
+}
+
+/*
+*	Computes the reciprocal multiplier for a calibrated full scale (e.g. maximum brightness).
+*	This is the only division; call it when the calibration changes, not per sample.
+*	The factor is rounded up, which keeps convert_calibratedPercent() exact for all full scales.
+*
+*	@param full_scale Raw value that corresponds to 100 % (1..4095)
+*	@return uint32_t Factor for convert_calibratedPercent()
+*/
+static inline uint32_t convert_calibration(uint16_t full_scale) {
+	if (full_scale == 0)
+		full_scale = 1;
+	return ((100UL << CONVERT_CAL_SHIFT) + full_scale - 1) / full_scale;
+}
+
+/*
+*	@param raw 12-Bit ADC result, must not exceed the calibrated full scale
+*	@param factor Result of convert_calibration()
+*	@return uint16_t Share of the calibrated full scale in % (0..100)
+*/
+static inline uint16_t convert_calibratedPercent(uint16_t raw, uint32_t factor) {
+	return convert_scale(raw, factor, CONVERT_CAL_SHIFT);
+}
+
+
+#endif /* CONVERT_H_ */
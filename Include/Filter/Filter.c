@@ -0,0 +1,154 @@
+/*
+ ***********************************************************************************
+ * @file:   Filter.c
+ * @date:   17.10.2026
+ *
+ * EMA, box-car average and median-of-3/5 on uint16_t samples.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Filter.h"
+
+// DEFINES //
+#define MIN(a, b)		((a) < (b) ? (a) : (b))
+#define MAX(a, b)		((a) < (b) ? (b) : (a))
+
+// Puts the smaller value into a and the larger into b //
+#define SORT(a, b)		do { uint16_t low = MIN(a, b); b = MAX(a, b); a = low; } while (0)
+
+// PRIVATE FUNCTION DECLARATIONS //
+static uint8_t window(const filter* f);
+static uint16_t median3(uint16_t a, uint16_t b, uint16_t c);
+static uint16_t median5(const uint16_t* values);
+
+// PUBLIC FUNCTIONS //
+/*
+*	@param f Filter object of the channel
+*	@param type Filter type
+*	@param shift FILTER_EMA: alpha = 1 / 2^shift (1..8), FILTER_AVERAGE: window = 2^shift (0..4), otherwise unused
+*	@return bool false if the shift is out of range (the filter then passes the samples unchanged)
+*/
+bool filter_init(filter* f, filter_type type, uint8_t shift) {
+
+	bool valid = true;
+	if (type == FILTER_EMA)
+		valid = shift >= 1 && shift <= FILTER_EMA_MAX_SHIFT;
+	else if (type == FILTER_AVERAGE)
+		valid = shift < 8 && (1 << shift) <= FILTER_HISTORY;
+	else
+		shift = 0;
+
+	f->type = valid ? type : FILTER_NONE;
+	f->shift = valid ? shift : 0;
+	filter_reset(f);
+
+	return valid;
+}
+
+/*
+*	Forgets all samples, the next sample restarts the filter.
+*	@param f Filter object of the channel
+*	@return None
+*/
+void filter_reset(filter* f) {
+	f->index = 0;
+	f->started = false;
+	f->sum = 0;
+	f->output = 0;
+}
+
+/*
+*	Adds a sample, constant time for every type.
+*	@param f Filter object of the channel
+*	@param value New sample
+*	@return uint16_t Filtered value
+*/
+uint16_t filter_update(filter* f, uint16_t value) {
+
+	// First sample: the history holds it everywhere, no ramp from 0 //
+	if (!f->started) {
+		for (uint8_t i = 0; i < FILTER_HISTORY; i++)
+			f->history[i] = value;
+		f->sum = (uint32_t)value << f->shift;
+		f->started = true;
+	}
+
+	switch (f->type) {
+		case FILTER_EMA:
+			// sum = y * 2^shift: sum += x - y with y rounded, so the output settles on x in both directions //
+			f->sum = f->sum - ((f->sum + (1UL << (f->shift - 1))) >> f->shift) + value;
+			f->output = (uint16_t)((f->sum + (1UL << (f->shift - 1))) >> f->shift);
+			break;
+
+		case FILTER_AVERAGE:
+			f->sum = f->sum - f->history[f->index] + value;
+			f->history[f->index] = value;
+			f->index = (f->index + 1) & (window(f) - 1);
+			f->output = (uint16_t)((f->sum + (f->shift ? 1UL << (f->shift - 1) : 0)) >> f->shift);
+			break;
+
+		case FILTER_MEDIAN3:
+		case FILTER_MEDIAN5:
+			f->history[f->index] = value;
+			if (++f->index == window(f))
+				f->index = 0;
+			f->output = (f->type == FILTER_MEDIAN3)
+				? median3(f->history[0], f->history[1], f->history[2])
+				: median5(f->history);
+			break;
+
+		default:
+			f->output = value;
+			break;
+	}
+
+	return f->output;
+}
+
+/*
+*	@param f Filter object of the channel
+*	@return uint16_t Result of the last filter_update() (0 before the first sample)
+*/
+uint16_t filter_value(const filter* f) {
+	return f->output;
+}
+
+// PRIVATE FUNCTIONS //
+// Number of samples in the circular buffer //
+static uint8_t window(const filter* f) {
+
+	switch (f->type) {
+		case FILTER_AVERAGE:	return 1 << f->shift;
+		case FILTER_MEDIAN3:	return 3;
+		case FILTER_MEDIAN5:	return 5;
+		default:				return 1;
+	}
+}
+
+// Median of three without sorting: max(min(a, b), min(max(a, b), c)) //
+static uint16_t median3(uint16_t a, uint16_t b, uint16_t c) {
+	return MAX(MIN(a, b), MIN(MAX(a, b), c));
+}
+
+// Median of five by seven compare-exchanges (the order of the samples does not matter) //
+static uint16_t median5(const uint16_t* values) {
+
+	uint16_t a = values[0], b = values[1], c = values[2], d = values[3], e = values[4];
+
+	SORT(a, b);
+	SORT(d, e);
+	SORT(a, d);
+	SORT(b, e);
+	SORT(b, c);
+	SORT(c, d);
+	SORT(b, c);
+
+	return c;
+}
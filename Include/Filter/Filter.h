@@ -0,0 +1,74 @@
+/*
+ ***********************************************************************************
+ * @file:   Filter.h
+ * @date:   17.10.2026
+ *
+ * Streaming integer filters for ADC samples, one filter object per channel:
+ *
+ *  - FILTER_EMA:     exponential moving average y += (x - y) / 2^shift. The state keeps
+ *                    shift fraction bits, so small steps are not lost to rounding.
+ *  - FILTER_AVERAGE: box-car average over the last 2^shift samples. A running sum is
+ *                    updated with the new and the oldest sample of a circular buffer.
+ *  - FILTER_MEDIAN3, FILTER_MEDIAN5: median of the last 3 / 5 samples by a fixed
+ *                    sequence of min/max compare-exchanges, removes single spikes.
+ *
+ * Each update costs a constant number of operations independent of the data
+ * (no loop over the window) and no division. The first sample fills the whole
+ * history, so the output starts at the first value instead of ramping up from 0.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  1. Call filter_init() for every channel with the type and the shift
+     (EMA: alpha = 1 / 2^shift, 1..8; average: window = 2^shift, 0..4; medians: ignored).
+  2. Pass every sample of the channel in order to filter_update(), e.g. while draining
+     adc_read(), and use its result or filter_value().
+*/
+
+
+#ifndef FILTER_H_
+#define FILTER_H_
+
+// INCLUDES //
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINES //
+#define FILTER_HISTORY		16		// Largest window (2^4), also holds the median windows
+#define FILTER_EMA_MAX_SHIFT	8	// 0xFFFF << 8 still fits into the 32-Bit state
+
+// ENUMS //
+typedef enum {
+	FILTER_NONE,			// Passes the samples unchanged
+	FILTER_EMA,				// Exponential moving average, alpha = 1 / 2^shift
+	FILTER_AVERAGE,			// Box-car average over 2^shift samples
+	FILTER_MEDIAN3,			// Median of the last 3 samples
+	FILTER_MEDIAN5			// Median of the last 5 samples
+} filter_type;
+
+// TYPES //
+typedef struct {
+	uint8_t type;						// filter_type
+	uint8_t shift;						// EMA: log2(1 / alpha), average: log2(window)
+	uint8_t index;						// Oldest sample of the circular buffer
+	bool started;						// At least one sample seen
+	uint32_t sum;						// EMA: output * 2^shift, average: sum of the window
+	uint16_t output;					// Result of the last update
+	uint16_t history[FILTER_HISTORY];	// Last samples (average and medians)
+} filter;
+
+// FUNCTION DECLARATIONS //
+bool filter_init(filter* f, filter_type type, uint8_t shift);
+
+void filter_reset(filter* f);
+
+uint16_t filter_update(filter* f, uint16_t value);
+
+uint16_t filter_value(const filter* f);
+
+
+#endif /* FILTER_H_ */
@@ -0,0 +1,199 @@
+/*
+ ***********************************************************************************
+ * @file:   Format.c
+ * @date:   17.10.2026
+ *
+ * Conversion of integers to decimal strings without division.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Format.h"
+
+// Variables //
+static const uint32_t powers_of_ten[] = {
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL
+};
+
+// PRIVATE FUNCTION DECLARATIONS //
+static uint8_t u16_digits(char* end, uint16_t number, uint8_t min_digits);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Converts an unsigned 16-Bit number to a decimal string.
+*	@param buffer Destination, at least FORMAT_U16_SIZE bytes
+*	@param number Number to be converted
+*	@return uint8_t Number of characters written (without terminator)
+*/
+uint8_t format_u16(char* buffer, uint16_t number) {
+	
+	char digits[FORMAT_U16_SIZE - 1];
+	uint8_t length = u16_digits(&digits[sizeof(digits)], number, 1);
+	
+	for (uint8_t pos = 0; pos < length; pos++)
+		buffer[pos] = digits[sizeof(digits) - length + pos];
+	buffer[length] = '\0';		// string terminator
+	
+	return length;
+}
+
+/*
+*	Converts a signed 16-Bit number to a decimal string.
+*	@param buffer Destination, at least FORMAT_S16_SIZE bytes
+*	@param number Number to be converted
+*	@return uint8_t Number of characters written (without terminator)
+*/
+uint8_t format_s16(char* buffer, int16_t number) {
+	
+	if (number < 0) {
+		buffer[0] = '-';
+		return 1 + format_u16(&buffer[1], (uint16_t)(0U - (uint16_t)number));
+	}
+	return format_u16(buffer, (uint16_t)number);
+}
+
+/*
+*	Converts an unsigned 32-Bit number to a decimal string.
+*	The digits above 10^4 are found by subtracting powers of ten (at most 9 per digit),
+*	the last four digits by the 16-Bit multiply-shift.
+*
+*	@param buffer Destination, at least FORMAT_U32_SIZE bytes
+*	@param number Number to be converted
+*	@return uint8_t Number of characters written (without terminator)
+*/
+uint8_t format_u32(char* buffer, uint32_t number) {
+	
+	if (number <= UINT16_MAX)
+		return format_u16(buffer, (uint16_t)number);
+	
+	uint8_t length = 0;
+	for (uint8_t index = 0; index < sizeof(powers_of_ten) / sizeof(powers_of_ten[0]); index++) {
+		uint32_t power = powers_of_ten[index];
+		char digit = '0';
+		
+		while (number >= power) {
+			number -= power;
+			digit++;
+		}
+		if (length > 0 || digit != '0')		// no leading zeros
+			buffer[length++] = digit;
+	}
+	
+	// Remainder < 10^4: exactly four digits, including zeros //
+	length += u16_digits(&buffer[length + 4], (uint16_t)number, 4);
+	buffer[length] = '\0';		// string terminator
+	
+	return length;
+}
+
+/*
+*	Converts a signed 32-Bit number to a decimal string.
+*	@param buffer Destination, at least FORMAT_S32_SIZE bytes
+*	@param number Number to be converted
+*	@return uint8_t Number of characters written (without terminator)
+*/
+uint8_t format_s32(char* buffer, int32_t number) {
+	
+	if (number < 0) {
+		buffer[0] = '-';
+		return 1 + format_u32(&buffer[1], 0UL - (uint32_t)number);
+	}
+	return format_u32(buffer, (uint32_t)number);
+}
+
+/*
+*	Converts a fixed-point number to a decimal string, e.g. -5 with 1 decimal to "-0.5".
+*	@param buffer Destination, at least FORMAT_DECIMAL_SIZE bytes
+*	@param number Number in units of 10^-decimals
+*	@param decimals Number of digits behind the decimal point (0..9)
+*	@return uint8_t Number of characters written (without terminator)
+*/
+uint8_t format_decimal(char* buffer, int32_t number, uint8_t decimals) {
+	
+	if (decimals == 0)
+		return format_s32(buffer, number);
+	
+	uint8_t length = 0;
+	uint32_t magnitude = (uint32_t)number;
+	if (number < 0) {
+		buffer[length++] = '-';
+		magnitude = 0UL - magnitude;
+	}
+	
+	char digits[FORMAT_U32_SIZE];
+	uint8_t count = format_u32(digits, magnitude);
+	
+	// Leading zeros, so that at least one digit stands in front of the point //
+	uint8_t total = (count > decimals) ? count : decimals + 1;
+	uint8_t zeros = total - count;
+	
+	for (uint8_t digit = 0; digit < total; digit++) {
+		if (digit == total - decimals)
+			buffer[length++] = '.';
+		buffer[length++] = (digit < zeros) ? '0' : digits[digit - zeros];
+	}
+	buffer[length] = '\0';		// string terminator
+	
+	return length;
+}
+
+/*
+*	Writes a number right-aligned into a field of fixed width, padded with spaces.
+*	A field that is always equally wide keeps the neighbouring text on the LCD in place.
+*	If the number does not fit, the field is filled with '#'.
+*
+*	@param field Destination, at least width + 1 bytes
+*	@param width Width of the field in characters
+*	@param number Number to be converted
+*	@return char* field
+*/
+char* format_fixed(char* field, uint8_t width, int32_t number) {
+	
+	char digits[FORMAT_S32_SIZE];
+	uint8_t length = format_s32(digits, number);
+	uint8_t pos = 0;
+	
+	if (length > width) {
+		while (pos < width)
+			field[pos++] = '#';
+	}
+	else {
+		while (pos < width - length)
+			field[pos++] = ' ';
+		for (uint8_t digit = 0; digit < length; digit++)
+			field[pos++] = digits[digit];
+	}
+	field[pos] = '\0';		// string terminator
+	
+	return field;
+}
+
+// PRIVATE FUNCTIONS //
+/*
+*	Writes the digits of a 16-Bit number backwards, ending before end.
+*	number / 10 is computed as number * 0xCCCD >> 19, which is exact for 0..65535.
+*
+*	@param end Position behind the last digit
+*	@param number Number to be converted
+*	@param min_digits Minimum number of digits, missing ones are written as '0'
+*	@return uint8_t Number of digits written
+*/
+static uint8_t u16_digits(char* end, uint16_t number, uint8_t min_digits) {
+	
+	uint8_t count = 0;
+	
+	do {
+		uint16_t quotient = (uint16_t)(((uint32_t)number * 0xCCCDU) >> 19);
+		*--end = (char)('0' + (number - quotient * 10));
+		number = quotient;
+		count++;
+	} while (number > 0 || count < min_digits);
+	
+	return count;
+}
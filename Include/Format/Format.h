@@ -0,0 +1,52 @@
+/*
+ ***********************************************************************************
+ * @file:   Format.h
+ * @date:   17.10.2026
+ *
+ * Conversion of integers to decimal strings without division.
+ *
+ * 16-Bit values are split into digits with a multiply-shift (x / 10 = x * 0xCCCD >> 19,
+ * exact for all 16-Bit values), 32-Bit values by subtracting powers of ten.
+ * Digits are written from the right, so no reversal pass is needed.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Required buffer sizes (including the terminator) are given by the FORMAT_*_SIZE defines.
+  format_decimal() prints a fixed-point number, e.g. 235 with 1 decimal as "23.5".
+  format_fixed() writes a right-aligned field of fixed width for LCD output.
+*/
+
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+// INCLUDES //
+#include <stdint.h>
+
+// DEFINES //
+#define FORMAT_U16_SIZE		6		// "65535"
+#define FORMAT_S16_SIZE		7		// "-32768"
+#define FORMAT_U32_SIZE		11		// "4294967295"
+#define FORMAT_S32_SIZE		12		// "-2147483648"
+#define FORMAT_DECIMAL_SIZE	13		// "-2.147483648", up to 9 decimals
+
+// FUNCTION DECLARATIONS //
+uint8_t format_u16(char* buffer, uint16_t number);
+
+uint8_t format_s16(char* buffer, int16_t number);
+
+uint8_t format_u32(char* buffer, uint32_t number);
+
+uint8_t format_s32(char* buffer, int32_t number);
+
+uint8_t format_decimal(char* buffer, int32_t number, uint8_t decimals);
+
+char* format_fixed(char* field, uint8_t width, int32_t number);
+
+
+#endif /* FORMAT_H_ */
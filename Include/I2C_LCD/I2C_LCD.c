@@ -34,6 +34,10 @@
 // DEFINES //
 #define DISPLAY_ADDRESS 0x27	// Only applies if Pins A1, A2 and A3 of the HW-061 are open (connected to Vdd)
 
+#ifndef LCD_I2C_MODE
+#define LCD_I2C_MODE NORMAL_MODE	// The PCF8574 is rated for 100kHz; faster modes are out of its specification
+#endif
+
 #define RS	0b00000001		// RS Enable
 #define RW	0b00000010		// RW Enable
 #define E	0b00000100		// E  Enable
@@ -47,12 +51,61 @@
 #define D6	0b01000000		// D6 Enable
 #define D7	0b10000000		// D7 Enable
 
+#ifndef LCD_BURST_SIZE
+#define LCD_BURST_SIZE	128		// Bytes per I2C burst (max. 255)
+#endif
+#define LCD_EXEC_US		41		// Execution time of a character write / most instructions (HD44780 Datasheet, Table 6)
+#define I2C_BYTE_BITS	9		// 8 data bits + ACK per I2C byte
+
+#ifndef LCD_BUSY_FLAG
+#define LCD_BUSY_FLAG	1		// 1: poll the busy flag (D7) after long instructions; 0: wait the worst-case execution time
+#endif
+#define LCD_BUSY_POLLS	64		// Upper limit of busy flag reads before giving up (covers the 1.52ms of Clear Display)
+
+#if LCD_BUSY_FLAG
+// A poll costs three I2C transactions; instructions up to LCD_EXEC_US are already covered by burst_pad.
+// If the busy flag cannot be read, the worst-case time is waited instead (_delay_us needs a constant) //
+#define LCD_WAIT(us)	do { if ((us) > LCD_EXEC_US && !lcd_wait_busy()) _delay_us(us); } while (0)
+#else
+#define LCD_WAIT(us)	_delay_us(us)
+#endif
+
+#define LCD_COLUMNS		16
+#define LCD_ROWS		2
+#define LCD_FLUSH_GAP	1		// Unchanged cells that lcd_flush() rewrites instead of moving the cursor (a move costs as much as one character)
+
 // VARIABLES //
 volatile i2c_status status = SUCCESS;
 volatile uint8_t display_state = 0x00;
 
+static uint8_t burst[LCD_BURST_SIZE];			// PCF8574 output sequence of the current burst
+static i2c_transaction burst_transaction = {
+	.address = DISPLAY_ADDRESS,
+	.read = false,
+	.data = burst,
+	.done = true
+};
+static uint8_t burst_pad = 0;					// Idle bytes after each character to cover LCD_EXEC_US
+static uint8_t burst_length = 0;				// Bytes collected in burst but not yet submitted
+
+static char shadow[LCD_ROWS][LCD_COLUMNS];		// Content requested with lcd_printAt()
+static char shown[LCD_ROWS][LCD_COLUMNS];		// Content currently on the display
+static bool shown_valid = false;				// false if the display was written behind the shadow's back
+static uint8_t cursor_x = 0xFF;					// Cursor position on the display (0xFF = unknown)
+static uint8_t cursor_y = 0xFF;
+static bool left_to_right = true;				// Current entry mode
+
 // PRIVATE FUNCTION DECLARATIONS //
 static i2c_status lcd_write_data(uint8_t data, bool rs, bool rw, bool init);
+static uint8_t    lcd_encode(uint8_t* buffer, uint8_t data, uint8_t control, bool init);
+static i2c_status lcd_sync(void);
+static i2c_status burst_begin(void);
+static i2c_status burst_append(uint8_t data, uint8_t control);
+static i2c_status burst_send(void);
+static void       invalidate_shown(void);
+#if LCD_BUSY_FLAG
+static bool       lcd_wait_busy(void);
+#endif
 
 // PUBLIC FUNCTIONS //
 
@@ -71,7 +124,14 @@ static i2c_status lcd_write_data(uint8_t data, bool rs, bool rw, bool init);
 */
 i2c_status lcd_init(void) {
 	
-	i2c_init();				// Init I2C-Bus
+	i2c_init(LCD_I2C_MODE);	// Init I2C-Bus
+	
+	// Every byte of a burst takes 9 SCL periods. Pad so that LCD_EXEC_US passes between two E pulses:
+	// (1 + burst_pad) byte times >= LCD_EXEC_US
+	uint32_t frequency = i2c_frequency();
+	burst_pad = (uint8_t)((LCD_EXEC_US * frequency + I2C_BYTE_BITS * 1000000UL - 1) / (I2C_BYTE_BITS * 1000000UL));
+	if (burst_pad > 0)
+		burst_pad--;
 		
 	status = i2c_write_byte(DISPLAY_ADDRESS, 0x00);	// Clear I2C I/O-Expander
 	if(status != SUCCESS)
@@ -104,7 +164,7 @@ i2c_status lcd_init(void) {
 	status = lcd_write_data(D3 + D5, 0, 0, false);	// 2 Lines, 5x8 Font size
 	if (status != SUCCESS)		
 		return status;
-	_delay_us(37);
+	LCD_WAIT(37);
 	
 	status = lcd_enable(true);		// Enable Display
 	if (status != SUCCESS)
@@ -121,6 +181,8 @@ i2c_status lcd_init(void) {
 	status = lcd_backlight(true);	// Enable backlight
 	if(status != SUCCESS)
 		return status;
+	
+	lcd_clearBuffer();				// Start with an empty framebuffer
 		
 	return SUCCESS;
 }
@@ -141,7 +203,7 @@ i2c_status lcd_enable(bool enable) {
 		if (status != SUCCESS)			// Disable Display
 			return status;
 	}
-	_delay_us(37);
+	LCD_WAIT(37);
 	
 	return SUCCESS;
 }
@@ -165,7 +227,7 @@ i2c_status lcd_backlight(bool enable) {
 		if (status != SUCCESS)			// Disable Display
 			return status;
 	}
-	_delay_us(37);
+	LCD_WAIT(37);
 		
 	return SUCCESS;
 }
@@ -179,7 +241,15 @@ i2c_status lcd_backlight(bool enable) {
 i2c_status lcd_clear(void) {
 	if (lcd_write_data(D0, 0, 0, false) != SUCCESS)				// Clear Display
 		return ERROR;
-	_delay_us(1600);
+	LCD_WAIT(1600);
+	
+	// Display is blank and the cursor is at home now //
+	for (uint8_t y = 0; y < LCD_ROWS; y++)
+		for (uint8_t x = 0; x < LCD_COLUMNS; x++)
+			shown[y][x] = ' ';
+	shown_valid = true;
+	cursor_x = 0;
+	cursor_y = 0;
 	
 	return SUCCESS;
 }
@@ -207,7 +277,10 @@ i2c_status lcd_moveCursor(uint8_t x, uint8_t y) {
 		
 	if (lcd_write_data(D7 + row_offset[y] + x, 0, 0, false) != SUCCESS)	// Move Cursor (DDRAM Address)
 		return ERROR;
-	_delay_us(37);
+	LCD_WAIT(37);
+	
+	cursor_x = x;
+	cursor_y = y;
 	
 	return SUCCESS;
 }
@@ -221,11 +294,9 @@ i2c_status lcd_moveCursor(uint8_t x, uint8_t y) {
 	@return i2c_status SUCCESS if operation succeeded. Any other: See AVR128DB48_I2C Module.
 */
 i2c_status lcd_putChar(char character) {
-	if (lcd_write_data(character, 1, 0, false) != SUCCESS)
-		return ERROR;
-	_delay_us(41);
-		
-	return SUCCESS;
+	char string[2] = {character, 0x0};
+	
+	return lcd_putString(string);
 }
 
 /*
@@ -233,19 +304,28 @@ i2c_status lcd_putChar(char character) {
 	The cursor will be incremented or decremented (only the horizontal position) after each such write;
 	dependent on whether lcd_leftToRight() (=incrementing) or lcd_rightToLeft() (=decrementing) was last executed.
 	
+	All characters are streamed to the I/O-Expander in a single I2C transaction (split only if the string
+	exceeds LCD_BURST_SIZE). The last transaction is sent in the background; the next LCD call waits for it.
+	
 	@param character The ASCII-value of the character to be written.
 	@return i2c_status SUCCESS if operation succeeded. Any other: See AVR128DB48_I2C Module.
 */
 i2c_status lcd_putString(char* string) {
-	while(*string != 0x0) {		
-		if (lcd_write_data(*string, 1, 0, false) != SUCCESS)
-			return ERROR;
-			
+	
+	invalidate_shown();		// Written behind the framebuffer
+	
+	status = burst_begin();
+	if (status != SUCCESS)
+		return status;
+	
+	while (*string != 0x0) {
+		status = burst_append(*string, RS);
+		if (status != SUCCESS)
+			return status;
 		string++;
-		_delay_us(41);
 	}
 	
-	return SUCCESS;
+	return burst_send();
 }
 
 /*
@@ -258,7 +338,8 @@ i2c_status lcd_putString(char* string) {
 i2c_status lcd_leftToRight(void) {
 	if (lcd_write_data(D1 + D2, 0, 0, false) != SUCCESS)	// Cursor moves from left to right
 		return ERROR;
-	_delay_us(37);
+	LCD_WAIT(37);
+	left_to_right = true;
 	
 	return SUCCESS;
 }
@@ -273,41 +354,252 @@ i2c_status lcd_leftToRight(void) {
 i2c_status lcd_rightToLeft(void) {
 	if (lcd_write_data(D2, 0, 0, false) != SUCCESS)			// Cursor moves from right to left
 		return ERROR;
-	_delay_us(37);
+	LCD_WAIT(37);
+	left_to_right = false;
 	
 	return SUCCESS;
 }
 
-// PRIVATE FUNCTIONS //
-static i2c_status lcd_write_data(uint8_t data, bool rs, bool rw, bool init) {
+/*
+	Fills the framebuffer with blanks. Nothing is sent to the display until lcd_flush().
 	
-	// Split Data in Low and High half //
-	uint8_t high_data = data & 0xF0;
-	uint8_t low_data = (data & 0x0F) << 4;
+	@param NONE
+	@return None
+*/
+void lcd_clearBuffer(void) {
+	for (uint8_t y = 0; y < LCD_ROWS; y++)
+		for (uint8_t x = 0; x < LCD_COLUMNS; x++)
+			shadow[y][x] = ' ';
+}
+
+/*
+	Writes a string into the framebuffer at the specified position.
+	Characters beyond the end of the row are dropped. Nothing is sent to the display until lcd_flush().
+	
+	@param x A value from 0 to 15. Specifies the horizontal position (column).
+	@param y A value from 0 to 1. Specifies the vertical position (row).
+	@param string The string to be written.
+	@return uint8_t The column following the last written character (for chaining calls).
+*/
+uint8_t lcd_printAt(uint8_t x, uint8_t y, const char* string) {
+	
+	// Constrain Rows //
+	if (y > 1)
+		y = 1;
+	
+	while (*string != 0x0 && x < LCD_COLUMNS) {
+		shadow[y][x] = *string;
+		x++;
+		string++;
+	}
 	
+	return x;
+}
 
+/*
+	Sends the cells of the framebuffer that differ from the display content.
+	Changed cells are grouped into runs; the cursor is only moved where a run does not
+	continue at the current cursor position. All runs are sent as one I2C burst in the background.
+	
+	@param NONE
+	@return i2c_status SUCCESS if operation succeeded. Any other: See AVR128DB48_I2C Module.
+*/
+i2c_status lcd_flush(void) {
+	
+	if (!left_to_right) {
+		status = lcd_leftToRight();
+		if (status != SUCCESS)
+			return status;
+	}
+	
+	status = burst_begin();
+	if (status != SUCCESS)
+		return status;
+	
+	for (uint8_t y = 0; y < LCD_ROWS; y++) {
+		uint8_t x = 0;
+		
+		while (x < LCD_COLUMNS) {
+			
+			if (shown_valid && shadow[y][x] == shown[y][x]) {
+				x++;
+				continue;
+			}
+			
+			// Extend the run over short unchanged gaps //
+			uint8_t end = x + 1;
+			while (end < LCD_COLUMNS) {
+				uint8_t next = end;
+				while (next < LCD_COLUMNS && next - end < LCD_FLUSH_GAP && shown_valid && shadow[y][next] == shown[y][next])
+					next++;
+				if (next < LCD_COLUMNS && (!shown_valid || shadow[y][next] != shown[y][next]))
+					end = next + 1;
+				else
+					break;
+			}
+			
+			// Move Cursor (DDRAM Address), if the run does not continue the last write //
+			if (cursor_x != x || cursor_y != y) {
+				status = burst_append(D7 + row_offset[y] + x, 0);
+				if (status != SUCCESS)
+					return status;
+			}
+			
+			for (; x < end; x++) {
+				status = burst_append(shadow[y][x], RS);
+				if (status != SUCCESS)
+					return status;
+				shown[y][x] = shadow[y][x];
+			}
+			cursor_x = end;
+			cursor_y = y;
+		}
+	}
+	shown_valid = true;
+	
+	return burst_send();
+}
+
+// PRIVATE FUNCTIONS //
+static i2c_status lcd_write_data(uint8_t data, bool rs, bool rw, bool init) {
+	
 	// Check if RS or RW shall be set
 	uint8_t control = 0;
 	if (rs)
 		control += RS;
 	if (rw)
 		control += RW;
-		
+	
+	status = lcd_sync();
+	if (status != SUCCESS)
+		return status;
+	
+	// Send the whole E-strobe sequence as one transaction and wait for it //
+	burst_transaction.length = lcd_encode(burst, data, control, init);
+	status = i2c_submit(&burst_transaction);
+	if (status != SUCCESS)
+		return status;
+	
+	return lcd_sync();
+}
+
+/*
+	Builds the PCF8574 output sequence for one HD44780 write in 4-Bit mode.
+	Each byte is latched by the I/O-Expander on its ACK, so the I2C byte time
+	itself provides the enable pulse width and the setup / hold times.
+	The sequence ends with burst_pad copies of the idle state to cover the execution time.
+	
+	@param buffer Destination, needs room for 4 + burst_pad bytes
+	@return uint8_t Number of bytes written to buffer
+*/
+static uint8_t lcd_encode(uint8_t* buffer, uint8_t data, uint8_t control, bool init) {
+	
+	// Split Data in Low and High half //
+	uint8_t high_data = (data & 0xF0) + control + display_state;
+	uint8_t low_data = ((data & 0x0F) << 4) + control + display_state;
+	
+	uint8_t length = 0;
+	
 	// Send Bits 7 - 4 //
-	if (i2c_write_byte(DISPLAY_ADDRESS, high_data + control + display_state + E) != SUCCESS)
-		return ERROR;
-	_delay_us(30);
-	if (i2c_write_byte(DISPLAY_ADDRESS, high_data + control + display_state) != SUCCESS)		// Pull enable low
-		return ERROR;
-	_delay_us(37);
-		
+	buffer[length++] = high_data + E;
+	buffer[length++] = high_data;				// Pull enable low
+	
 	// Send Bits 3 - 0 (Only if not in initialization sequence) //
 	if (!init) {
-		if (i2c_write_byte(DISPLAY_ADDRESS, low_data + control + display_state + E) != SUCCESS)
-			return ERROR;
-		_delay_us(30);
-		if (i2c_write_byte(DISPLAY_ADDRESS, low_data + control + display_state) != SUCCESS)		// Pull enable low
-			return ERROR;
+		buffer[length++] = low_data + E;
+		buffer[length++] = low_data;			// Pull enable low
 	}
+	
+	uint8_t idle = buffer[length - 1];
+	for (uint8_t pad = 0; pad < burst_pad; pad++)
+		buffer[length++] = idle;				// Keep outputs unchanged while the LCD executes
+	
+	return length;
+}
+
+// Waits for the previous burst and starts collecting a new one //
+static i2c_status burst_begin(void) {
+	burst_length = 0;
+	return lcd_sync();
+}
+
+// Adds one HD44780 write to the burst, submitting and waiting if the buffer is full //
+static i2c_status burst_append(uint8_t data, uint8_t control) {
+	
+	if (burst_length > LCD_BURST_SIZE - 4 - burst_pad) {
+		status = burst_send();
+		if (status != SUCCESS)
+			return status;
+		status = lcd_sync();
+		if (status != SUCCESS)
+			return status;
+	}
+	burst_length += lcd_encode(&burst[burst_length], data, control, false);
+	
 	return SUCCESS;
 }
+
+// Submits the collected burst without waiting for it //
+static i2c_status burst_send(void) {
+	
+	if (burst_length == 0)
+		return SUCCESS;
+	
+	burst_transaction.length = burst_length;
+	burst_length = 0;
+	
+	return i2c_submit(&burst_transaction);
+}
+
+#if LCD_BUSY_FLAG
+/*
+	Waits until the HD44780 has finished the last instruction by reading the busy flag.
+	The data lines of the I/O-Expander are set high (quasi-bidirectional inputs) and the LCD is
+	read with RW = 1, RS = 0. In 4-Bit mode each read needs two E pulses; D7 of the first one is the busy flag.
+	RW is set with E low first, so the address setup time (tAS) passes before the E pulse.
+	On a bus error or after LCD_BUSY_POLLS busy reads the function gives up and LCD_WAIT()
+	waits the worst-case execution time instead.
+	@return bool true if the LCD reported ready, false if the caller has to wait
+*/
+static bool lcd_wait_busy(void) {
+	
+	uint8_t input = D4 + D5 + D6 + D7 + RW + display_state;
+	uint8_t setup[2] = {input, input + E};				// RW = 1 with E low, then E high
+	uint8_t strobe[3] = {input, input + E, input};		// E low, second nibble, E low
+	
+	status = lcd_sync();
+	if (status != SUCCESS)
+		return false;
+	
+	for (uint8_t poll = 0; poll < LCD_BUSY_POLLS; poll++) {
+		uint8_t port = 0;
+		
+		// First nibble: E high, read D7..D4 //
+		if (i2c_write(DISPLAY_ADDRESS, setup, sizeof(setup)) != SUCCESS)
+			return false;
+		if (i2c_read_byte(DISPLAY_ADDRESS, &port) != SUCCESS)
+			return false;
+		
+		// Finish the read cycle (low nibble is not needed) //
+		if (i2c_write(DISPLAY_ADDRESS, strobe, sizeof(strobe)) != SUCCESS)
+			return false;
+		
+		if (!(port & D7))
+			return true;
+	}
+	return false;
+}
+#endif
+
+// Display content and cursor are no longer known to the framebuffer //
+static void invalidate_shown(void) {
+	shown_valid = false;
+	cursor_x = 0xFF;
+	cursor_y = 0xFF;
+}
+
+// Waits until the last burst has left the bus and returns its result //
+static i2c_status lcd_sync(void) {
+	i2c_wait(&burst_transaction);
+	return burst_transaction.status;
+}
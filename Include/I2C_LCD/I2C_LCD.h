@@ -23,6 +23,9 @@
  SCL - PA3
  
  Call lcd_init() before using any other function.
+ 
+ For periodically refreshed screens, write into the framebuffer with lcd_printAt()
+ and call lcd_flush(): only cells that changed since the last flush are sent.
  */
 
 
@@ -42,4 +45,9 @@ i2c_status lcd_putString(char* string);
 i2c_status lcd_leftToRight(void);
 i2c_status lcd_rightToLeft(void);
 
+// Framebuffer: write with lcd_printAt(), send only the changed cells with lcd_flush() //
+void lcd_clearBuffer(void);
+uint8_t lcd_printAt(uint8_t x, uint8_t y, const char* string);
+i2c_status lcd_flush(void);
+
 #endif /* I2C_LCD_H_ */
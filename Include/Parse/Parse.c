@@ -0,0 +1,108 @@
+/*
+ ***********************************************************************************
+ * @file:   Parse.c
+ * @date:   17.10.2026
+ *
+ * Single-pass parser for lines of comma separated, unsigned decimal fields.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Parse.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// PRIVATE FUNCTION DECLARATIONS //
+static bool is_blank(char character);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Reads exactly count comma separated decimal values from a zero terminated line.
+*	Every character is looked at once; values are only stored up to count.
+*
+*	@param text Zero terminated line
+*	@param values Storage for count values
+*	@param count Number of expected fields
+*	@param max Largest allowed value of a field
+*	@param position Receives the index of the character where parsing stopped (may be NULL)
+*	@return parse_status PARSE_OK or the reason why the line was rejected
+*/
+parse_status parse_fields(const char* text, uint16_t* values, uint8_t count, uint16_t max, uint8_t* position) {
+	
+	parse_status status = PARSE_OK;
+	uint8_t pos = 0;
+	uint8_t field = 0;
+	
+	// value * 10 + digit > max  <=>  value > max / 10, or value == max / 10 and digit > max % 10 //
+	uint16_t limit = max / 10;		// The only division, once per call
+	uint8_t last = max % 10;
+	
+	while (1) {
+		while (is_blank(text[pos]))
+			pos++;
+		
+		// Field: at least one digit //
+		if (text[pos] < '0' || text[pos] > '9') {
+			status = (text[pos] == ',' || text[pos] == '\0') ? PARSE_EMPTY_FIELD : PARSE_INVALID_CHARACTER;
+			break;
+		}
+		
+		uint16_t value = 0;
+		while (text[pos] >= '0' && text[pos] <= '9') {
+			uint8_t digit = text[pos] - '0';
+			
+			if (value > limit || (value == limit && digit > last)) {
+				status = PARSE_OUT_OF_RANGE;
+				break;
+			}
+			value = value * 10 + digit;
+			pos++;
+		}
+		if (status != PARSE_OK)
+			break;
+		
+		values[field] = value;
+		field++;
+		
+		while (is_blank(text[pos]))
+			pos++;
+		
+		// Separator or end of line //
+		if (text[pos] == ',') {
+			if (field == count) {
+				status = PARSE_TOO_MANY_FIELDS;
+				break;
+			}
+			pos++;
+		}
+		else if (text[pos] == '\0') {
+			if (field < count)
+				status = PARSE_TOO_FEW_FIELDS;
+			break;
+		}
+		else {
+			status = PARSE_INVALID_CHARACTER;
+			break;
+		}
+	}
+	
+	if (position != NULL)
+		*position = pos;
+	
+	return status;
+}
+
+// PRIVATE FUNCTIONS //
+/*
+*	@param character Character to be checked
+*	@return bool true for blanks, tabs and line breaks
+*/
+static bool is_blank(char character) {
+	return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+}
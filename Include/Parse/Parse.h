@@ -0,0 +1,42 @@
+/*
+ ***********************************************************************************
+ * @file:   Parse.h
+ * @date:   17.10.2026
+ *
+ * Single-pass parser for lines of comma separated, unsigned decimal fields
+ * such as "255,128,0". Replaces sscanf() and reports why and where a line
+ * was rejected.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Blanks, tabs and line breaks around a field are ignored, so input from a terminal
+  may contain "\r\n" from the previous line.
+*/
+
+
+#ifndef PARSE_H_
+#define PARSE_H_
+
+// INCLUDES //
+#include <stdint.h>
+
+// ENUMS //
+typedef enum {
+	PARSE_OK,					// All fields were read
+	PARSE_EMPTY_FIELD,			// A field contains no digits, e.g. "1,,3"
+	PARSE_INVALID_CHARACTER,	// A character other than a digit, comma or blank was found
+	PARSE_OUT_OF_RANGE,			// A value is larger than the allowed maximum
+	PARSE_TOO_FEW_FIELDS,		// The line ended before all fields were read
+	PARSE_TOO_MANY_FIELDS		// The line contains more fields than expected
+} parse_status;
+
+// FUNCTION DECLARATIONS //
+parse_status parse_fields(const char* text, uint16_t* values, uint8_t count, uint16_t max, uint8_t* position);
+
+
+#endif /* PARSE_H_ */
@@ -0,0 +1,126 @@
+/*
+ ***********************************************************************************
+ * @file:   Power.c
+ * @date:   17.10.2026
+ *
+ * Sleep between interrupts and accounting of the time asleep and awake.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Power.h"
+#include "RTC.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <stddef.h>
+
+// Variables //
+static uint16_t last = 0;			// RTC count of the last update
+static uint32_t total = 0;			// RTC ticks since the last reset
+static uint32_t asleep = 0;			// Part of total spent sleeping
+
+// PRIVATE FUNCTION DECLARATIONS //
+static uint16_t update(void);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Starts the RTC (internal 32.768kHz, also running in standby) as time base.
+*	@return None
+*/
+void power_init(void) {
+	
+	rtc_init();
+	power_resetStatistics();
+}
+
+/*
+*	Sleeps until the next interrupt unless work is pending.
+*	Global interrupts are enabled on return.
+*
+*	@param mode SLEEP_MODE_IDLE or SLEEP_MODE_STANDBY
+*	@param work Returns true if the main loop has something to do (may be NULL)
+*	@return None
+*/
+void power_sleep(uint8_t mode, power_work work) {
+	
+	cli();
+	if (work != NULL && work()) {
+		sei();
+		return;
+	}
+	
+	uint16_t start = update();
+	set_sleep_mode(mode);
+	sleep_enable();
+	sei();				// The instruction after SEI is executed before any interrupt
+	sleep_cpu();
+	sleep_disable();
+	
+	// The waking ISR has run before this point and is counted as asleep //
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		asleep += (uint16_t)(update() - start);
+	}
+}
+
+/*
+*	@param asleep_ticks Receives the RTC ticks spent sleeping since the last reset
+*	@param awake_ticks Receives the RTC ticks spent running since the last reset
+*	@return None
+*/
+void power_statistics(uint32_t* asleep_ticks, uint32_t* awake_ticks) {
+	
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		update();
+		*asleep_ticks = asleep;
+		*awake_ticks = total - asleep;
+	}
+}
+
+/*
+*	@return uint16_t Time awake since the last reset in 0.1% (0 .. 1000)
+*/
+uint16_t power_dutyCycle(void) {
+	
+	uint32_t asleep_ticks;
+	uint32_t awake_ticks;
+	power_statistics(&asleep_ticks, &awake_ticks);
+	
+	uint32_t sum = asleep_ticks + awake_ticks;
+	if (sum == 0)
+		return 0;
+	while (sum > 0x400000UL) {		// awake * 1000 must fit into 32 Bit
+		sum >>= 1;
+		awake_ticks >>= 1;
+	}
+	return (uint16_t)((awake_ticks * 1000 + sum / 2) / sum);
+}
+
+/*
+*	Starts a new measuring interval.
+*	@return None
+*/
+void power_resetStatistics(void) {
+	
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		last = RTC.CNT;
+		total = 0;
+		asleep = 0;
+	}
+}
+
+// PRIVATE FUNCTIONS //
+// Adds the RTC ticks since the last call to the total //
+static uint16_t update(void) {
+	
+	uint16_t now = RTC.CNT;
+	total += (uint16_t)(now - last);
+	last = now;
+	
+	return now;
+}
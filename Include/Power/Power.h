@@ -0,0 +1,57 @@
+/*
+ ***********************************************************************************
+ * @file:   Power.h
+ * @date:   17.10.2026
+ *
+ * Lets the main loop sleep (SLPCTRL) whenever it has nothing to do. The wake-up
+ * sources are the interrupts of the application, e.g. PORTC pin changes, USART3 RXC,
+ * TCA0 overflow or ADC0 RESRDY: each interrupt wakes the CPU, the main loop handles
+ * the new work and calls power_sleep() again.
+ *
+ * The time spent asleep and awake is measured with the RTC (1 tick = 30.5us), so the
+ * duty cycle of the CPU can be reported.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  1. Call power_init() once at start (it starts the shared RTC, see RTC.h, if nobody did).
+  2. End every pass of the main loop with power_sleep(mode, work). work() is called with
+     interrupts disabled and returns true if the loop can continue right away; otherwise
+     the CPU sleeps until the next interrupt. An interrupt between the check and the
+     SLEEP instruction cannot be missed.
+  3. SLEEP_MODE_IDLE keeps every peripheral running. SLEEP_MODE_STANDBY also stops the
+     peripheral clock: only pin changes and peripherals with RUNSTDBY wake the CPU, and
+     the USART must have finished sending (usart_txDone()).
+  power_sleep() has to be called at least once per RTC wrap (2s) for exact statistics.
+*/
+
+
+#ifndef POWER_H_
+#define POWER_H_
+
+// INCLUDES //
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// TYPES //
+typedef bool (*power_work)(void);
+
+// FUNCTION DECLARATIONS //
+void power_init(void);
+
+void power_sleep(uint8_t mode, power_work work);
+
+void power_statistics(uint32_t* asleep_ticks, uint32_t* awake_ticks);
+
+uint16_t power_dutyCycle(void);
+
+void power_resetStatistics(void);
+
+
+#endif /* POWER_H_ */
@@ -0,0 +1,32 @@
+/*
+ ***********************************************************************************
+ * @file:   RTC.c
+ * @date:   17.10.2026
+ *
+ * Start of the RTC counter shared by the ADC, Buttons and Power modules.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "RTC.h"
+
+// PUBLIC FUNCTIONS //
+/*
+*	Starts the RTC (internal 32.768kHz, also running in standby), unless it runs already.
+*	@return None
+*/
+void rtc_init(void) {
+	
+	if (RTC.CTRLA & RTC_RTCEN_bm)
+		return;
+	
+	while (RTC.STATUS > 0);							// Wait until the RTC registers are synchronized
+	RTC.CLKSEL = RTC_CLKSEL_OSC32K_gc;				// Internal 32.768kHz oscillator
+	RTC.CTRLA = RTC_PRESCALER_DIV1_gc | RTC_RUNSTDBY_bm | RTC_RTCEN_bm;
+}
@@ -0,0 +1,33 @@
+/*
+ ***********************************************************************************
+ * @file:   RTC.h
+ * @date:   17.10.2026
+ *
+ * Common time base of the modules: the RTC counter, clocked by the internal
+ * 32.768kHz oscillator without prescaler (1 tick = 30.5us, wraps every 2s).
+ * It keeps counting in standby (RUNSTDBY), so timestamps and the sleep statistics
+ * stay correct whichever module started it first.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Modules that read RTC.CNT or use the PIT call rtc_init() in their own init function;
+  the first call starts the RTC, later calls leave it running.
+*/
+
+
+#ifndef RTC_H_
+#define RTC_H_
+
+// INCLUDES //
+#include <avr/io.h>
+
+// FUNCTION DECLARATIONS //
+void rtc_init(void);
+
+
+#endif /* RTC_H_ */
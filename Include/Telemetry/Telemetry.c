@@ -0,0 +1,337 @@
+/*
+ ***********************************************************************************
+ * @file:   Telemetry.c
+ * @date:   17.10.2026
+ *
+ * Sends ADC samples over the USART as text lines or as COBS framed binary records
+ * protected by a CRC-16. In compressed mode, samples are delta coded per channel
+ * and collected into blocks.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Telemetry.h"
+#include "USART.h"
+#include "Format.h"
+#include <util/crc16.h>
+
+// DEFINES //
+#define ASCII_LINE_SIZE		16		// "65535,255,65535\n"
+#define SAMPLE_MAX_SIZE		6		// Two varints of up to 19 / 17 Bits
+#define CHANNELS			8		// Channel number is coded in 3 Bits
+
+#if TELEMETRY_BLOCK_SIZE + 2 > USART_TX_BUFFER_SIZE - 1
+#error "A compressed block must fit into the USART transmit buffer"
+#endif
+
+#if TELEMETRY_BLOCK_SIZE < 4 + SAMPLE_MAX_SIZE + 2 || TELEMETRY_BLOCK_SIZE > 253
+#error "TELEMETRY_BLOCK_SIZE must hold at least one sample and not exceed 253"
+#endif
+
+// Variables //
+static telemetry_mode mode = TELEMETRY_DEFAULT_MODE;
+static uint8_t dropped = 0;		// Samples not sent because the transmit buffer was full
+
+static uint8_t block[TELEMETRY_BLOCK_SIZE];
+static uint8_t block_length = 0;	// Bytes in the open block, 0: no block open
+static uint8_t block_sequence = 0;	// Sequence number of the next block
+static uint8_t blocks_to_key = 0;	// Delta blocks until the next key block
+static uint16_t last_timestamp;		// Timestamp of the previous sample in the block stream
+static uint16_t last_value[CHANNELS];	// Previous value per channel
+
+// PRIVATE FUNCTION DECLARATIONS //
+static bool send_binary(const adc_sample* sample);
+static bool send_ascii(const adc_sample* sample);
+static bool send_compressed(const adc_sample* sample);
+static void open_block(uint16_t timestamp);
+static bool flush_block(void);
+static uint8_t encode_sample(const adc_sample* sample, uint8_t* data);
+static uint8_t put_varint(uint8_t* data, uint32_t value);
+static bool queue_frame(const uint8_t* payload, uint8_t length);
+static uint8_t cobs_encode(const uint8_t* data, uint8_t length, uint8_t* frame);
+
+// PUBLIC FUNCTIONS //
+/*
+*	Selects the format of the following samples.
+*	@param new_mode TELEMETRY_ASCII, TELEMETRY_BINARY or TELEMETRY_COMPRESSED
+*	@return None
+*/
+void telemetry_setMode(telemetry_mode new_mode) {
+	
+	if (mode == TELEMETRY_COMPRESSED && new_mode != TELEMETRY_COMPRESSED && !telemetry_flush())
+		block_length = 0;		// Block could not be sent and is discarded
+	
+	if (new_mode != mode)
+		blocks_to_key = 0;		// The receiver may have missed blocks in between
+	
+	mode = new_mode;
+}
+
+/*
+*	@return telemetry_mode Format currently used
+*/
+telemetry_mode telemetry_getMode(void) {
+	return mode;
+}
+
+/*
+*	Queues one sample in the current format.
+*	@param sample Sample to be send
+*	@return bool true if the sample was queued, false if it was dropped
+*/
+bool telemetry_send(const adc_sample* sample) {
+	
+	bool sent;
+	
+	switch (mode) {
+		case TELEMETRY_BINARY:
+			sent = send_binary(sample);
+			break;
+		case TELEMETRY_COMPRESSED:
+			sent = send_compressed(sample);
+			break;
+		default:
+			sent = send_ascii(sample);
+			break;
+	}
+	
+	if (!sent && dropped < UINT8_MAX)
+		dropped++;
+	
+	return sent;
+}
+
+/*
+*	Sends the open compressed block, even if it is not full.
+*	@return bool true if no block is pending afterwards
+*/
+bool telemetry_flush(void) {
+	
+	if (block_length == 0)
+		return true;
+	return flush_block();
+}
+
+/*
+*	@return uint8_t Number of samples dropped because the transmit buffer was full (saturates at 255)
+*/
+uint8_t telemetry_dropped(void) {
+	return dropped;
+}
+
+// PRIVATE FUNCTIONS //
+/*
+*	Builds the record, appends the CRC and queues the COBS frame.
+*	@param sample Sample to be send
+*	@return bool true if the frame was queued
+*/
+static bool send_binary(const adc_sample* sample) {
+	
+	uint8_t payload[TELEMETRY_RECORD_SIZE];
+	payload[0] = TELEMETRY_TYPE_SAMPLE;
+	payload[1] = (uint8_t)sample->timestamp;
+	payload[2] = (uint8_t)(sample->timestamp >> 8);
+	payload[3] = sample->channel;
+	payload[4] = (uint8_t)sample->value;
+	payload[5] = (uint8_t)(sample->value >> 8);
+	
+	return queue_frame(payload, TELEMETRY_RECORD_SIZE);
+}
+
+/*
+*	Queues the line "timestamp,channel,value\n".
+*	@param sample Sample to be send
+*	@return bool true if the line was queued
+*/
+static bool send_ascii(const adc_sample* sample) {
+	
+	if (usart_txFree() < ASCII_LINE_SIZE)
+		return false;
+	
+	usart_putUnsigned(sample->timestamp);
+	usart_putChar(',');
+	usart_putUnsigned(sample->channel);
+	usart_putChar(',');
+	usart_putUnsigned(sample->value);
+	usart_putChar('\n');
+	
+	return true;
+}
+
+/*
+*	Adds a sample to the open block. A full block is sent first; if it still does not fit
+*	into the transmit buffer, the sample is dropped and the block is kept for the next try.
+*
+*	@param sample Sample to be send
+*	@return bool true if the sample was added
+*/
+static bool send_compressed(const adc_sample* sample) {
+	
+	uint8_t data[SAMPLE_MAX_SIZE];
+	uint8_t length = 0;
+	
+	if (block_length > 0) {
+		length = encode_sample(sample, data);
+		if (block_length + length + 2 > TELEMETRY_BLOCK_SIZE) {
+			if (!flush_block())
+				return false;
+		}
+	}
+	
+	if (block_length == 0) {
+		open_block(sample->timestamp);
+		length = encode_sample(sample, data);	// Previous values may have been reset
+	}
+	
+	for (uint8_t pos = 0; pos < length; pos++)
+		block[block_length++] = data[pos];
+	
+	last_timestamp = sample->timestamp;
+	last_value[sample->channel & (CHANNELS - 1)] = sample->value;
+	
+	return true;
+}
+
+/*
+*	Starts a new block; a key block resets the previous values.
+*	@param timestamp Timestamp of the first sample
+*	@return None
+*/
+static void open_block(uint16_t timestamp) {
+	
+	block[1] = block_sequence;
+	
+	if (blocks_to_key == 0) {
+		block[0] = TELEMETRY_TYPE_KEY;
+		block[2] = (uint8_t)timestamp;
+		block[3] = (uint8_t)(timestamp >> 8);
+		block_length = 4;
+		
+		last_timestamp = timestamp;
+		for (uint8_t channel = 0; channel < CHANNELS; channel++)
+			last_value[channel] = 0;
+		blocks_to_key = TELEMETRY_KEY_INTERVAL - 1;
+	}
+	else {
+		block[0] = TELEMETRY_TYPE_DELTA;
+		block_length = 2;
+		blocks_to_key--;
+	}
+}
+
+/*
+*	Queues the open block as one frame.
+*	@return bool true if the block was queued
+*/
+static bool flush_block(void) {
+	
+	if (!queue_frame(block, block_length))
+		return false;
+	
+	block_length = 0;
+	block_sequence++;
+	return true;
+}
+
+/*
+*	Codes a sample relative to the previous sample and the previous value of its channel.
+*	@param sample Sample to be coded
+*	@param data Destination, at least SAMPLE_MAX_SIZE bytes
+*	@return uint8_t Number of bytes written
+*/
+static uint8_t encode_sample(const adc_sample* sample, uint8_t* data) {
+	
+	uint8_t channel = sample->channel & (CHANNELS - 1);
+	uint16_t dt = sample->timestamp - last_timestamp;
+	int16_t delta = (int16_t)(sample->value - last_value[channel]);		// modulo 2^16
+	uint16_t zigzag = ((uint16_t)delta << 1) ^ (uint16_t)(delta >> 15);
+	
+	uint8_t length = put_varint(data, ((uint32_t)dt << 3) | channel);
+	length += put_varint(&data[length], zigzag);
+	
+	return length;
+}
+
+/*
+*	Writes a value as varint: 7 Bits per byte, LSB first, bit 7 set if more bytes follow.
+*	@param data Destination
+*	@param value Value to be written
+*	@return uint8_t Number of bytes written
+*/
+static uint8_t put_varint(uint8_t* data, uint32_t value) {
+	
+	uint8_t length = 0;
+	
+	while (value >= 0x80) {
+		data[length++] = (uint8_t)value | 0x80;
+		value >>= 7;
+	}
+	data[length++] = (uint8_t)value;
+	
+	return length;
+}
+
+/*
+*	Appends the CRC to the payload and queues it as one COBS frame.
+*	@param payload Payload without CRC
+*	@param length Length of the payload without CRC
+*	@return bool true if the frame was queued, false if the transmit buffer has not enough room
+*/
+static bool queue_frame(const uint8_t* payload, uint8_t length) {
+	
+	if (usart_txFree() < length + 2 + 2)
+		return false;
+	
+	uint8_t data[TELEMETRY_BLOCK_SIZE];
+	uint16_t crc = 0xFFFF;
+	
+	for (uint8_t pos = 0; pos < length; pos++) {
+		data[pos] = payload[pos];
+		crc = _crc_xmodem_update(crc, payload[pos]);
+	}
+	data[length] = (uint8_t)crc;
+	data[length + 1] = (uint8_t)(crc >> 8);
+	
+	uint8_t frame[TELEMETRY_BLOCK_SIZE + 2];
+	usart_write(frame, cobs_encode(data, length + 2, frame));
+	
+	return true;
+}
+
+/*
+*	Consistent Overhead Byte Stuffing for payloads shorter than 254 bytes.
+*	Every zero byte is replaced by the distance to the next one; the frame ends with 0x00.
+*
+*	@param data Payload
+*	@param length Length of the payload (max. 253)
+*	@param frame Destination, at least length + 2 bytes
+*	@return uint8_t Length of the frame including the delimiter
+*/
+static uint8_t cobs_encode(const uint8_t* data, uint8_t length, uint8_t* frame) {
+	
+	uint8_t code_pos = 0;	// Position of the pending code byte
+	uint8_t code = 1;		// Distance from the code byte to the next zero
+	uint8_t out = 1;
+	
+	for (uint8_t pos = 0; pos < length; pos++) {
+		if (data[pos] == 0) {
+			frame[code_pos] = code;
+			code_pos = out++;
+			code = 1;
+		}
+		else {
+			frame[out++] = data[pos];
+			code++;
+		}
+	}
+	frame[code_pos] = code;
+	frame[out++] = 0x00;	// Frame delimiter
+	
+	return out;
+}
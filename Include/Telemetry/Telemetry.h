@@ -0,0 +1,92 @@
+/*
+ ***********************************************************************************
+ * @file:   Telemetry.h
+ * @date:   17.10.2026
+ *
+ * Sends ADC samples over the USART either as readable text or as compact binary
+ * frames. A binary frame is 10 bytes instead of about 40 characters, so at 9600 Baud
+ * about 96 samples per second fit on the line.
+ *
+ * Binary frame (all values little-endian):
+ *   record  = type (1 byte, TELEMETRY_TYPE_SAMPLE), timestamp (2), channel (1), value (2)
+ *   payload = record + CRC-16/CCITT-FALSE of the record (2; poly 0x1021, init 0xFFFF)
+ *   frame   = COBS(payload) + 0x00
+ * COBS removes every zero byte from the payload, so 0x00 only occurs as frame delimiter
+ * and a receiver resynchronizes after a lost byte. The matching host decoder is in
+ * Host/Telemetry.
+ *
+ * Compressed mode packs as many samples as fit into TELEMETRY_BLOCK_SIZE into one frame:
+ *   block   = type (TELEMETRY_TYPE_KEY or TELEMETRY_TYPE_DELTA), sequence number (1),
+ *             [key only: timestamp of the first sample (2)], samples..., CRC (2)
+ *   sample  = varint(dt << 3 | channel), varint(zigzag(value - previous value of the channel))
+ * dt is the timestamp difference to the previous sample (modulo 2^16). Varints carry 7 Bits
+ * per byte (LSB first), zig-zag maps 0, -1, 1, -2 .. to 0, 1, 2, 3 .. . A key block resets all
+ * previous values to 0, so its first sample per channel is absolute. Every
+ * TELEMETRY_KEY_INTERVAL-th block is a key block; after a lost block (gap in the sequence
+ * numbers) the receiver waits for the next one. A slowly varying signal needs about 2 bytes
+ * per sample instead of 10.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  1. Call usart_init(); the start mode is TELEMETRY_DEFAULT_MODE (build time).
+  2. Call telemetry_send() for every sample. A sample that does not fit completely into the
+     transmit buffer is dropped and counted, so no partial frame is ever queued.
+  3. telemetry_setMode() switches the format at run time, e.g. on a serial command.
+  4. In compressed mode a block is sent once it is full. Call telemetry_flush() to send
+     a partly filled block, e.g. before the stream pauses.
+*/
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+// INCLUDES //
+#include <stdint.h>
+#include <stdbool.h>
+#include "ADC.h"
+
+// DEFINES //
+#define TELEMETRY_TYPE_SAMPLE	0x01	// Record type of a single sample
+#define TELEMETRY_TYPE_KEY		0x02	// Compressed block starting from absolute values
+#define TELEMETRY_TYPE_DELTA	0x03	// Compressed block continuing the previous one
+
+#define TELEMETRY_RECORD_SIZE	6		// type, timestamp, channel, value
+#define TELEMETRY_FRAME_SIZE	(TELEMETRY_RECORD_SIZE + 2 + 2)	// + CRC, COBS code byte and delimiter
+
+#ifndef TELEMETRY_BLOCK_SIZE
+#define TELEMETRY_BLOCK_SIZE	48		// Payload of a compressed block including CRC (frame: + 2)
+#endif
+
+#ifndef TELEMETRY_KEY_INTERVAL
+#define TELEMETRY_KEY_INTERVAL	8		// Every n-th compressed block is a key block
+#endif
+
+// ENUMS //
+typedef enum {
+	TELEMETRY_ASCII,	// One line "timestamp,channel,value\n" per sample
+	TELEMETRY_BINARY,	// One COBS frame per sample
+	TELEMETRY_COMPRESSED	// Blocks of delta coded samples
+} telemetry_mode;
+
+#ifndef TELEMETRY_DEFAULT_MODE
+#define TELEMETRY_DEFAULT_MODE	TELEMETRY_ASCII
+#endif
+
+// FUNCTION DECLARATIONS //
+void telemetry_setMode(telemetry_mode mode);
+
+telemetry_mode telemetry_getMode(void);
+
+bool telemetry_send(const adc_sample* sample);
+
+bool telemetry_flush(void);
+
+uint8_t telemetry_dropped(void);
+
+
+#endif /* TELEMETRY_H_ */
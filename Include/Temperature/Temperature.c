@@ -0,0 +1,70 @@
+/*
+ ***********************************************************************************
+ * @file:   Temperature.c
+ * @date:   17.10.2026
+ *
+ * Fixed-point conversion of the internal temperature sensor with the factory
+ * calibration cached in RAM.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#include "Temperature.h"
+
+// DEFINES //
+#define FRACTION_BITS	16		// 12-Bit result * 16 and division by 4096 -> 2^16
+
+// Variables //
+static int32_t offset = 0;		// TEMPSENSE1 in 1/16 LSB
+static uint16_t slope = 0;		// TEMPSENSE0
+
+// PUBLIC FUNCTIONS //
+/*
+*	Reads the calibration of the temperature sensor from the signature row.
+*	@return None
+*/
+void temperature_init(void) {
+	offset = (int32_t)SIGROW.TEMPSENSE1 << 4;
+	slope = SIGROW.TEMPSENSE0;
+}
+
+/*
+*	@param value ADC result of the temperature sensor
+*	@param sampnum Accumulation of the channel (adc_channel.sampnum), ADC_SAMPNUM_NONE_gc: 12-Bit result
+*	@return int32_t Temperature in 0.01K, rounded
+*/
+int32_t temperature_centiKelvin(uint16_t value, uint8_t sampnum) {
+	
+	int32_t scaled = value;
+	if ((sampnum & ADC_SAMPNUM_gm) == ADC_SAMPNUM_NONE_gc)
+		scaled <<= 4;			// Same scale as an accumulated result
+	
+	// |offset - value| * slope fits into 32 Bit (16 x 16 Bit), the factor 100 is applied //
+	// to the integer Kelvin and the 16 fraction bits separately, so no 64-Bit arithmetic //
+	int32_t difference = offset - scaled;
+	uint16_t magnitude = difference < 0 ? -difference : difference;
+	uint32_t product = (uint32_t)magnitude * slope;
+	
+	uint32_t kelvin = (product >> FRACTION_BITS) * 100;
+	uint32_t fraction = (product & ((1UL << FRACTION_BITS) - 1)) * 100;
+	
+	// Rounded half up like (x + 0.5) for both signs //
+	if (difference < 0)
+		return -(int32_t)(kelvin + ((fraction + (1UL << (FRACTION_BITS - 1)) - 1) >> FRACTION_BITS));
+	return (int32_t)(kelvin + ((fraction + (1UL << (FRACTION_BITS - 1))) >> FRACTION_BITS));
+}
+
+/*
+*	@param value ADC result of the temperature sensor
+*	@param sampnum Accumulation of the channel (adc_channel.sampnum), ADC_SAMPNUM_NONE_gc: 12-Bit result
+*	@return int32_t Temperature in 0.01degC, rounded
+*/
+int32_t temperature_centiCelsius(uint16_t value, uint8_t sampnum) {
+	return temperature_centiKelvin(value, sampnum) - TEMPERATURE_ZERO_CELSIUS;
+}
@@ -0,0 +1,46 @@
+/*
+ ***********************************************************************************
+ * @file:   Temperature.h
+ * @date:   17.10.2026
+ *
+ * Conversion of results of the internal temperature sensor (ADC_MUXPOS_TEMPSENSE_gc,
+ * reference 2.048V) to fixed-point temperatures, without floating point.
+ *
+ * The factory calibration TEMPSENSE0 (slope) and TEMPSENSE1 (offset) is read from
+ * the signature row once by temperature_init():
+ *     T[K] = (TEMPSENSE1 - RES) * TEMPSENSE0 / 4096
+ * The difference is signed, so readings above the calibrated offset do not wrap.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Pass the sampnum of the ADC channel with the result: accumulated results of the
+  ADC module are left-aligned to 16 Bit (1/16 LSB) and converted with 4 more bits
+  of resolution, so oversampling reduces the noise of the temperature as well.
+  Print with usart_putDecimal(centi, 2), e.g. 2531 -> "25.31".
+*/
+
+
+#ifndef TEMPERATURE_H_
+#define TEMPERATURE_H_
+
+// INCLUDES //
+#include <avr/io.h>
+#include <stdint.h>
+
+// DEFINES //
+#define TEMPERATURE_ZERO_CELSIUS	27315	// 0 degC in centi-Kelvin
+
+// FUNCTION DECLARATIONS //
+void temperature_init(void);
+
+int32_t temperature_centiKelvin(uint16_t value, uint8_t sampnum);
+
+int32_t temperature_centiCelsius(uint16_t value, uint8_t sampnum);
+
+
+#endif /* TEMPERATURE_H_ */
@@ -0,0 +1,343 @@
+/*
+ ***********************************************************************************
+ * @file:   USART.c
+ * @date:   17.10.2026
+ *
+ * This module drives USART3 (Curiosity Virtual COM Port) with an interrupt-driven
+ * transmitter: bytes are queued into a ring buffer and drained by the
+ * Data Register Empty interrupt, so the caller never waits for the line.
+ *
+ * Received bytes go into a second ring buffer. Both rings are single-producer /
+ * single-consumer: each index is written by exactly one side (main program or
+ * interrupt), so no interrupt locking is needed.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+ */
+
+// INCLUDES //
+#ifndef F_CPU
+#define F_CPU 4000000UL
+#endif
+#include "USART.h"
+#include "Format.h"
+#include <avr/interrupt.h>
+
+// DEFINES //
+#ifndef USART_CLK2X
+#if BAUD_RATE > F_CPU / 16
+#define USART_CLK2X		1
+#else
+#define USART_CLK2X		0
+#endif
+#endif
+
+#if USART_CLK2X
+#define SAMPLES			8		// Samples per bit in double speed mode
+#define RXMODE			USART_RXMODE_CLK2X_gc
+#else
+#define SAMPLES			16		// Samples per bit in normal mode
+#define RXMODE			USART_RXMODE_NORMAL_gc
+#endif
+
+// BAUD = 64 * F_CPU / (SAMPLES * BAUD_RATE), rounded (Data sheet -> USART -> Baud Rate Generator) //
+#define BAUD_VALUE		((64UL * F_CPU + SAMPLES * (BAUD_RATE) / 2) / (SAMPLES * (BAUD_RATE)))
+#define BAUD_ACTUAL		(64UL * F_CPU / (SAMPLES * BAUD_VALUE))
+
+#if BAUD_VALUE < 64
+#error "BAUD_RATE is too high for F_CPU (maximum F_CPU / 8 with CLK2X)"
+#endif
+
+#if BAUD_VALUE > 65535
+#error "BAUD_RATE is too low for F_CPU"
+#endif
+
+#if BAUD_ACTUAL * 1000 > (BAUD_RATE) * (1000 + USART_BAUD_TOLERANCE) || BAUD_ACTUAL * 1000 < (BAUD_RATE) * (1000 - USART_BAUD_TOLERANCE)
+#error "Baud rate error exceeds USART_BAUD_TOLERANCE"
+#endif
+
+#define TX_MASK		(USART_TX_BUFFER_SIZE - 1)
+
+#if (USART_TX_BUFFER_SIZE & TX_MASK) != 0 || USART_TX_BUFFER_SIZE > 256
+#error "USART_TX_BUFFER_SIZE must be a power of two and not larger than 256"
+#endif
+
+#define RX_MASK		(USART_RX_BUFFER_SIZE - 1)
+#define FRAME_MASK	(USART_RX_FRAMES - 1)
+
+#if (USART_RX_BUFFER_SIZE & RX_MASK) != 0 || USART_RX_BUFFER_SIZE > 256
+#error "USART_RX_BUFFER_SIZE must be a power of two and not larger than 256"
+#endif
+
+#if (USART_RX_FRAMES & FRAME_MASK) != 0 || USART_RX_FRAMES > 128
+#error "USART_RX_FRAMES must be a power of two and not larger than 128"
+#endif
+
+// TYPES //
+typedef struct {
+	uint8_t offset;		// Position of the first byte in rx_buffer
+	uint8_t length;		// Number of bytes (terminator excluded)
+} usart_frame;
+
+// Variables //
+static volatile uint8_t tx_buffer[USART_TX_BUFFER_SIZE];
+static volatile uint8_t tx_head = 0;		// Next free slot, only written by the main program
+static volatile uint8_t tx_tail = 0;		// Next byte to send, only written by the DRE interrupt
+static volatile uint8_t tx_high_water = 0;	// Maximum fill level seen since the last reset
+static bool tx_used = false;				// Something was queued since usart_init()
+
+static volatile uint8_t rx_buffer[USART_RX_BUFFER_SIZE];
+static volatile uint8_t rx_head = 0;		// Next free slot, only written by the RXC interrupt
+static volatile uint8_t rx_tail = 0;		// End of the oldest unread frame, only written by the main program
+static uint8_t rx_frame_start = 0;			// Start of the frame currently being received (interrupt only)
+static bool rx_overflow = false;			// Current frame did not fit and will be dropped (interrupt only)
+static volatile uint8_t rx_dropped = 0;		// Number of frames lost because a buffer was full
+
+static volatile usart_frame frames[USART_RX_FRAMES];
+static volatile uint8_t frame_head = 0;	// Next free frame slot, only written by the RXC interrupt
+static volatile uint8_t frame_tail = 0;	// Oldest unread frame, only written by the main program
+
+// PUBLIC FUNCTIONS //
+/*
+*	Initializes USART3 with 8N1 and BAUD_RATE, enables transmitter and receiver.
+*	@return None
+*/
+void usart_init(void) {
+	
+	USART3.BAUD = (uint16_t)BAUD_VALUE;								// Baud-Setting, computed at compile time
+	USART3.CTRLC = USART_CHSIZE_8BIT_gc;							// Data format: 8 Bit, no parity, 1 stop bit
+	USART3.CTRLB = USART_TXEN_bm | USART_RXEN_bm | RXMODE;			// Enable TX and RX, normal or double speed
+	USART3.CTRLA |= USART_RXCIE_bm;									// Receive into the ring buffer
+	
+	PORTB.DIRSET = PIN0_bm;		// TX as output
+	PORTB.DIRCLR = PIN1_bm;		// RX as input
+}
+
+/*
+*	Queues data for transmission without waiting for the line.
+*	If the ring buffer has not enough room, only the leading part of the data is queued.
+*
+*	@param data Data as Byte-Array to be send
+*	@param length Length of the Data Byte-Array
+*	@return uint8_t Number of bytes actually queued
+*/
+uint8_t usart_write(const uint8_t* data, uint8_t length) {
+	
+	uint8_t head = tx_head;
+	uint8_t free = (uint8_t)(tx_tail - head - 1) & TX_MASK;
+	
+	if (length > free)
+		length = free;
+	
+	for (uint8_t pos = 0; pos < length; pos++) {
+		tx_buffer[head] = data[pos];
+		head = (head + 1) & TX_MASK;
+	}
+	tx_head = head;		// Publish the new bytes before the interrupt is enabled
+	
+	// Track the fill level //
+	uint8_t used = (uint8_t)(head - tx_tail) & TX_MASK;
+	if (used > tx_high_water)
+		tx_high_water = used;
+	
+	if (length > 0) {
+		tx_used = true;
+		USART3.STATUS = USART_TXCIF_bm;		// Set again when the new data has been shifted out
+		USART3.CTRLA |= USART_DREIE_bm;		// (Re-)start draining the buffer
+	}
+	
+	return length;
+}
+
+/*
+*	Queues one character for transmission.
+*	@param character Character to be send
+*	@return uint8_t 1 if the character was queued, 0 if the buffer is full
+*/
+uint8_t usart_putChar(char character) {
+	return usart_write((const uint8_t*)&character, 1);
+}
+
+/*
+*	Queues a zero terminated string for transmission.
+*	@param string String to be send
+*	@return uint8_t Number of characters actually queued
+*/
+uint8_t usart_putString(const char* string) {
+	
+	uint8_t length = 0;
+	while (string[length] != '\0' && length < USART_TX_BUFFER_SIZE - 1)
+		length++;
+	
+	return usart_write((const uint8_t*)string, length);
+}
+
+/*
+*	Queues an unsigned number as decimal text.
+*	@param number Number to be send
+*	@return uint8_t Number of characters actually queued
+*/
+uint8_t usart_putUnsigned(uint32_t number) {
+	
+	char digits[FORMAT_U32_SIZE];
+	return usart_write((const uint8_t*)digits, format_u32(digits, number));
+}
+
+/*
+*	Queues a signed number as decimal text.
+*	@param number Number to be send
+*	@return uint8_t Number of characters actually queued
+*/
+uint8_t usart_putSigned(int32_t number) {
+	
+	char digits[FORMAT_S32_SIZE];
+	return usart_write((const uint8_t*)digits, format_s32(digits, number));
+}
+
+/*
+*	Queues a fixed-point number as decimal text, e.g. 235 with 1 decimal as "23.5".
+*	@param number Number in units of 10^-decimals
+*	@param decimals Number of digits behind the decimal point (0..9)
+*	@return uint8_t Number of characters actually queued
+*/
+uint8_t usart_putDecimal(int32_t number, uint8_t decimals) {
+	
+	char digits[FORMAT_DECIMAL_SIZE];
+	return usart_write((const uint8_t*)digits, format_decimal(digits, number, decimals));
+}
+
+/*
+*	Waits until every queued byte has been handed to the transmitter.
+*	@return None
+*/
+void usart_flush(void) {
+	while (tx_tail != tx_head);
+}
+
+/*
+*	@return uint8_t Number of bytes that can be queued without truncation
+*/
+uint8_t usart_txFree(void) {
+	return (uint8_t)(tx_tail - tx_head - 1) & TX_MASK;
+}
+
+/*
+*	@return bool true if the buffer is empty and the transmitter has sent the last stop bit
+*/
+bool usart_txDone(void) {
+	return tx_tail == tx_head && (!tx_used || (USART3.STATUS & USART_TXCIF_bm));
+}
+
+/*
+*	@return uint8_t Highest number of bytes that were waiting in the transmit buffer
+*/
+uint8_t usart_txHighWater(void) {
+	return tx_high_water;
+}
+
+/*
+*	Resets the high-water mark of the transmit buffer.
+*	@return None
+*/
+void usart_txResetHighWater(void) {
+	tx_high_water = 0;
+}
+
+/*
+*	Copies the oldest completed frame into the given buffer and releases it.
+*	The frame terminator is not copied, the result is always zero terminated.
+*	Frames longer than size - 1 are truncated.
+*
+*	@param frame Destination buffer
+*	@param size Size of the destination buffer in bytes (0: nothing is copied or released)
+*	@return bool true if a frame was copied, false if no frame is pending
+*/
+bool usart_readFrame(char* frame, uint8_t size) {
+	
+	uint8_t tail = frame_tail;
+	if (tail == frame_head || size == 0)
+		return false;
+	
+	uint8_t offset = frames[tail].offset;
+	uint8_t length = frames[tail].length;
+	
+	uint8_t copy = length;
+	if (copy > size - 1)
+		copy = size - 1;
+	for (uint8_t pos = 0; pos < copy; pos++)
+		frame[pos] = rx_buffer[(offset + pos) & RX_MASK];
+	frame[copy] = '\0';
+	
+	// Release the bytes first, then the frame slot //
+	rx_tail = (offset + length) & RX_MASK;
+	frame_tail = (tail + 1) & FRAME_MASK;
+	
+	return true;
+}
+
+/*
+*	@return bool true if a completed frame is waiting for usart_readFrame()
+*/
+bool usart_framePending(void) {
+	return frame_tail != frame_head;
+}
+
+/*
+*	@return uint8_t Number of received frames that were dropped because a buffer was full
+*/
+uint8_t usart_rxDropped(void) {
+	return rx_dropped;
+}
+
+// INTERRUPTS //
+ISR(USART3_DRE_vect) {
+	
+	uint8_t tail = tx_tail;
+	
+	USART3.TXDATAL = tx_buffer[tail];
+	tail = (tail + 1) & TX_MASK;
+	tx_tail = tail;
+	
+	if (tail == tx_head)
+		USART3.CTRLA &= ~USART_DREIE_bm;	// Buffer empty -> stop until the next usart_write()
+}
+
+ISR(USART3_RXC_vect) {
+	
+	uint8_t received = USART3.RXDATAL;
+	uint8_t head = rx_head;
+	
+	if (received == USART_FRAME_END) {
+		uint8_t slot = frame_head;
+		uint8_t next = (slot + 1) & FRAME_MASK;
+		
+		if (rx_overflow || next == frame_tail) {
+			head = rx_frame_start;		// Discard the bytes of the lost frame
+			rx_dropped++;
+		}
+		else {
+			frames[slot].offset = rx_frame_start;
+			frames[slot].length = (head - rx_frame_start) & RX_MASK;
+			frame_head = next;
+		}
+		rx_overflow = false;
+		rx_frame_start = head;
+		rx_head = head;
+		return;
+	}
+	
+	if (rx_overflow)
+		return;
+	
+	uint8_t next = (head + 1) & RX_MASK;
+	if (next == rx_tail) {
+		rx_overflow = true;		// Ring full -> drop the rest of this frame
+		return;
+	}
+	rx_buffer[head] = received;
+	rx_head = next;
+}
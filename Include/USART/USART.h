@@ -0,0 +1,106 @@
+/*
+ ***********************************************************************************
+ * @file:   USART.h
+ * @date:   17.10.2026
+ *
+ * This module drives USART3 (Curiosity Virtual COM Port) with an interrupt-driven
+ * transmitter: bytes are queued into a ring buffer and drained by the
+ * Data Register Empty interrupt, so the caller never waits for the line.
+ *
+ * The receiver stores incoming bytes in a second ring buffer. The receive interrupt
+ * splits the stream into frames terminated by USART_FRAME_END and queues each
+ * completed frame by offset and length, so several commands can be pending at once.
+ *
+ * *********************************************************************************
+ *
+ * Mikroprozessortechnik
+ * Technische Hochschule Mittelhessen
+ *
+ ***********************************************************************************
+
+  Connections:
+  TX - PB0
+  RX - PB1
+
+  1. Call usart_init() and enable global interrupts (sei()) before using any other function.
+     The BAUD register value is computed at compile time. Double speed (CLK2X) is used
+     automatically if BAUD_RATE exceeds F_CPU / 16 (override with USART_CLK2X = 0 / 1).
+     Highest rate: F_CPU / 8, i.e. 500kBaud at 4MHz; 1MBaud needs F_CPU >= 8MHz.
+  2. Use usart_write(), usart_putChar() or usart_putString() to queue data.
+     These functions never block; they return the number of bytes actually queued.
+     usart_putUnsigned(), usart_putSigned() and usart_putDecimal() convert numbers directly
+     into the transmit buffer (no snprintf and no intermediate line buffer).
+  3. Use usart_flush() if the caller has to wait until everything was sent.
+     usart_txDone() tells when the last stop bit has left the pin (e.g. before standby,
+     which stops the USART).
+  4. Poll usart_readFrame() to fetch the oldest completed frame (without terminator).
+     usart_framePending() checks for a frame without removing it.
+*/
+
+
+#ifndef USART_H_
+#define USART_H_
+
+// INCLUDES //
+#include <avr/io.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// DEFINES //
+#ifndef BAUD_RATE
+#define BAUD_RATE			9600	// Build with e.g. -DBAUD_RATE=115200 for streaming
+#endif
+
+#ifndef USART_BAUD_TOLERANCE
+#define USART_BAUD_TOLERANCE	10		// Largest accepted baud rate error in 0.1% (checked at compile time)
+#endif
+
+#ifndef USART_TX_BUFFER_SIZE
+#define USART_TX_BUFFER_SIZE	64		// Size of the transmit ring buffer (power of two, max. 256)
+#endif
+
+#ifndef USART_RX_BUFFER_SIZE
+#define USART_RX_BUFFER_SIZE	128		// Size of the receive ring buffer (power of two, max. 256)
+#endif
+
+#ifndef USART_RX_FRAMES
+#define USART_RX_FRAMES			8		// Number of completed frames that can be queued (power of two)
+#endif
+
+#ifndef USART_FRAME_END
+#define USART_FRAME_END			'.'		// Character terminating a received frame
+#endif
+
+// FUNCTION DECLARATIONS //
+void usart_init(void);
+
+uint8_t usart_write(const uint8_t* data, uint8_t length);
+
+uint8_t usart_putChar(char character);
+
+uint8_t usart_putString(const char* string);
+
+uint8_t usart_putUnsigned(uint32_t number);
+
+uint8_t usart_putSigned(int32_t number);
+
+uint8_t usart_putDecimal(int32_t number, uint8_t decimals);
+
+void usart_flush(void);
+
+uint8_t usart_txFree(void);
+
+bool usart_txDone(void);
+
+uint8_t usart_txHighWater(void);
+
+void usart_txResetHighWater(void);
+
+bool usart_readFrame(char* frame, uint8_t size);
+
+bool usart_framePending(void);
+
+uint8_t usart_rxDropped(void);
+
+
+#endif /* USART_H_ */
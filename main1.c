@@ -8,80 +8,80 @@
 #include <avr/io.h>
 #include "AVR128DB48_I2C.h"
 #include "I2C_LCD.h"
+#include "ADC.h"
 #include <util/delay.h>
+#include <avr/interrupt.h>
 
-#define REF_SPANNUNG 3.3
-#define ADC_MAX_STUFE 4095  // 2^N - 1 = 4095 mit N (bit-auflsung) = 12
-#define SIZE 7
+#define CONVERT_REF_MV 3300 // Referenzspannung VDD in mV, ADC_MAX_STUFE = 2^N - 1 = 4095 mit N (bit-auflsung) = 12
+#include "Convert.h"
+#include "Format.h"
+#include "Filter.h"
 
+#define ABTASTRATE 40 // Messwerte pro Sekunde, in 500 ms passen sie in den Ringpuffer des ADC
 
-char* int_to_string(uint16_t number, char* zeichenkette) {
-	int position = 0;
-
-	if (number == 0) {
-		zeichenkette[position++] = '0';
-	}
-
-	while (number > 0) {
-		zeichenkette[position++] = '0' + number % 10;
-		number /= 10;
-	}
-
-	zeichenkette[position] = '\0'; // string terminator
-
-	for (int i = 0; i < position / 2; i++) {
-		char contener = zeichenkette[i];
-		zeichenkette[i] = zeichenkette[position - 1 - i];
-		zeichenkette[position - 1 - i] = contener;
-	}
-	return zeichenkette;
-}
 
-
-void ADC_init() {
-	VREF.ADC0REF = VREF_REFSEL_VDD_gc;          // Rfrenzspannung = VDD
-	ADC0.MUXPOS = ADC_MUXPOS_AIN19_gc;           // chanel AIN3 (PF3) Potentiometer = AIN19
-	ADC0.CTRLA = ADC_ENABLE_bm | ADC_RESSEL_12BIT_gc; // //adc aktivieren und  Auflsung auf 12-bit Setzen
-	ADC0.CTRLB = ADC_SAMPNUM_NONE_gc;           // //keine Akkumulation
-	ADC0.CTRLC = ADC_PRESC_DIV16_gc;             // Prescaler 
-}
-
-uint16_t ADC_Wandlung(void) {
-	ADC0.COMMAND = ADC_STCONV_bm;               // Convertion starten
-	while (!(ADC0.INTFLAGS & ADC_RESRDY_bm));   // Warten bis die Konvertion beendet ist
-	ADC0.INTFLAGS = ADC_RESRDY_bm;              //Interrupt Flag lschen
-	return ADC0.RES;                            //  Ergebnis von ADC lesen
-}
+// Potentiometer an AIN19, Referenzspannung = VDD
+const adc_channel potentiometer = {
+	.muxpos = ADC_MUXPOS_AIN19_gc,
+	.reference = VREF_REFSEL_VDD_gc,
+	.initdly = ADC_INITDLY_DLY0_gc,
+	.sampctrl = 0
+};
 
 int main(void) {
-	char spannung_string[SIZE];
-	char prozent_string[SIZE];
+	char spannung_string[6]; // Feld mit fester Breite: 5 Zeichen + Terminator
+	char prozent_string[4];  // 3 Zeichen + Terminator
 
 	
-	ADC_init();
+	adc_init(&potentiometer, 1);
+	sei(); // I2C-bertragungen und ADC-Wandlungen laufen im Interrupt
+	bool adc_laeuft = adc_startTriggered(ABTASTRATE); // ADC wandelt ab jetzt im Hintergrund mit fester Rate
 	lcd_init();
 	lcd_enable(true);
 
+	if (!adc_laeuft) {
+		// ABTASTRATE ist mit dem Timer bzw. der Wandlungsdauer nicht erreichbar
+		lcd_printAt(0, 0, "ADC-Fehler:");
+		lcd_printAt(0, 1, "Rate ungueltig");
+		lcd_flush();
+		while (1) {}
+	}
+
+	// Glttung: EMA mit alpha = 1/8 (Zeitkonstante 8 Messwerte = 200 ms)
+	filter glaettung;
+	filter_init(&glaettung, FILTER_EMA, 3);
+
 	while (1) {
-		// Wert von ADC lesen
-		uint16_t ADC_Wert = ADC_Wandlung();
+		// Alle Messwerte seit dem letzten Durchlauf in der richtigen Reihenfolge filtern
+		adc_sample messung;
+		bool neu = false;
+		while (adc_read(&messung)) {
+			filter_update(&glaettung, messung.value);
+			neu = true;
+		}
+		if (!neu) {
+			continue;
+		}
+		uint16_t ADC_Wert = filter_value(&glaettung);
 		
 		
-		uint16_t spannung = (uint16_t)((ADC_Wert * REF_SPANNUNG * 100) / ADC_MAX_STUFE); // en mV
-		uint16_t prozent = (uint16_t)((ADC_Wert * 100) / ADC_MAX_STUFE);                // en %
+		uint16_t spannung = convert_millivolt(ADC_Wert); // en mV (Festkomma, ohne float und Division)
+		uint16_t prozent = convert_percent(ADC_Wert);    // en %
+
 
+		// Bildschirm im Framebuffer aufbauen, lcd_flush() sendet nur die genderten Zeichen
+		lcd_clearBuffer();
 
-		lcd_clear();
+		// Zahlen rechtsbndig in Feldern fester Breite, damit der Text daneben nicht springt
+		uint8_t x = lcd_printAt(0, 0, "Spannung:");
+		x = lcd_printAt(x, 0, format_fixed(spannung_string, 5, spannung));
+		lcd_printAt(x, 0, "mV");
 
-		lcd_moveCursor(0, 0);
-		lcd_putString("Spannung: ");
-		lcd_putString(int_to_string(spannung, spannung_string));
-		lcd_putString(" mV");
+		x = lcd_printAt(0, 1, "Prozent: ");
+		x = lcd_printAt(x, 1, format_fixed(prozent_string, 3, prozent));
+		lcd_printAt(x, 1, " %");
 
-		lcd_moveCursor(0, 1);
-		lcd_putString("Prozent: ");
-		lcd_putString(int_to_string(prozent, prozent_string));
-		lcd_putString(" %");
+		lcd_flush();
 
 		_delay_ms(500);
 	}
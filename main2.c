@@ -9,89 +9,125 @@
 #include <avr/io.h>
 #include "AVR128DB48_I2C.h"
 #include "I2C_LCD.h"
+#include "ADC.h"
 #include <util/delay.h>
+#include <avr/interrupt.h>
+#include <string.h>
+#include "USART.h"
+#include "Calibration.h"
 
-#define REF_SPANNUNG 3.3
-#define ADC_MAX_STUFE 4095
-#define SIZE 7
+#define CONVERT_REF_MV 3300 // Referenzspannung VDD in mV
+#include "Convert.h"
+#include "Format.h"
+#include "Filter.h"
 
-// Umwandlung von Integer in String
-char* int_to_string(uint16_t number, char* zeichenkette) {
-	int position = 0;
+#define ABTASTRATE 40 // Messwerte pro Sekunde, in 500 ms passen sie in den Ringpuffer des ADC
 
-	if (number == 0) {
-		zeichenkette[position++] = '0';
-	}
-
-	while (number > 0) {
-		zeichenkette[position++] = '0' + number % 10;
-		number /= 10;
-	}
 
-	zeichenkette[position] = '\0'; // String-Terminator
-
-	for (int i = 0; i < position / 2; i++) {
-		char contener = zeichenkette[i];
-		zeichenkette[i] = zeichenkette[position - 1 - i];
-		zeichenkette[position - 1 - i] = contener;
-	}
-	return zeichenkette;
-}
-
-void ADC_init(){
-	VREF.ADC0REF = VREF_REFSEL_VDD_gc; 
-	ADC0.MUXPOS = ADC_MUXPOS_AIN18_gc;
-	ADC0.CTRLA = ADC_ENABLE_bm | ADC_RESSEL_12BIT_gc;
-	ADC0.CTRLB = ADC_SAMPNUM_NONE_gc;
-	ADC0.CTRLC = ADC_PRESC_DIV16_gc;
-}
-
-// Funktion zur ADC-Messung
-uint16_t ADC_Wandlung(void) {
-	ADC0.COMMAND = ADC_STCONV_bm;               // Start der Konvertierung
-	while (!(ADC0.INTFLAGS & ADC_RESRDY_bm));   // Warten, bis die Konvertierung fertig ist
-	ADC0.INTFLAGS = ADC_RESRDY_bm;              // Interrupt-Flag lschen
-	return ADC0.RES;                            // Ergebnis zurckgeben
-}
+// Fotowiderstand an AIN18, Referenzspannung = VDD
+const adc_channel fotowiderstand = {
+	.muxpos = ADC_MUXPOS_AIN18_gc,
+	.reference = VREF_REFSEL_VDD_gc,
+	.initdly = ADC_INITDLY_DLY0_gc,
+	.sampctrl = 0
+};
 
 
 int main(void) {
-	char spannung_string[SIZE];
-	char prozent_string[SIZE];
+	char spannung_string[6]; // Feld mit fester Breite: 5 Zeichen + Terminator
+	char prozent_string[4];  // 3 Zeichen + Terminator
+
+	char befehl[16];
 
 	// Initialisierungen
-	ADC_init();
+	usart_init();
+	adc_init(&fotowiderstand, 1);
+	sei(); // I2C-bertragungen und ADC-Wandlungen laufen im Interrupt
+	bool adc_laeuft = adc_startTriggered(ABTASTRATE); // ADC wandelt ab jetzt im Hintergrund mit fester Rate
 	lcd_init();
 	lcd_enable(true);
 
-	// Kalibrierung: Maximalwert fr 100 %
-	uint16_t adc_max_wert = 0; // Kalibrierung durch maximale Helligkeit mit Lampe
+	if (!adc_laeuft) {
+		// ABTASTRATE ist mit dem Timer bzw. der Wandlungsdauer nicht erreichbar
+		lcd_printAt(0, 0, "ADC-Fehler:");
+		lcd_printAt(0, 1, "Rate ungueltig");
+		lcd_flush();
+		while (1) {}
+	}
+
+	// Median aus 5 Messwerten: einzelne Ausreier (Flackern einer Lampe) verschwinden und verstellen die Kalibrierung nicht
+	filter glaettung;
+	filter_init(&glaettung, FILTER_MEDIAN5, 0);
+
+	// Kalibrierung: Minimum fr 0 % und Maximum fr 100 %, aus dem EEPROM und durch Abdunkeln / Lampe gelernt
+	calibration kalibrierung;
+	if (calibration_load(&kalibrierung)) {
+		usart_putString("Kalibrierung geladen: ");
+		usart_putUnsigned(kalibrierung.min);
+		usart_putString(" .. ");
+		usart_putUnsigned(kalibrierung.max);
+		usart_putChar('\n');
+	}
+	else {
+		usart_putString("Keine Kalibrierung gespeichert\n");
+	}
+	uint32_t kalibrier_faktor = convert_calibration(kalibrierung.max - kalibrierung.min); // Kehrwert der Spanne, nur bei nderung neu berechnet
 
 	while (1) {
 		
-		uint16_t ADC_Wert = ADC_Wandlung();
+		// Alle Messwerte seit dem letzten Durchlauf in der richtigen Reihenfolge filtern
+		adc_sample messung;
+		bool neu = false;
+		while (adc_read(&messung)) {
+			filter_update(&glaettung, messung.value);
+			neu = true;
+		}
+		if (!neu) {
+			continue;
+		}
+		uint16_t ADC_Wert = filter_value(&glaettung);
 
-	
-		if (adc_max_wert < ADC_Wert) {
-			adc_max_wert = ADC_Wert;
+		// Befehl "reset." ber USART lscht die Kalibrierung
+		if (usart_readFrame(befehl, sizeof(befehl)) && strcmp(befehl, "reset") == 0) {
+			calibration_erase(&kalibrierung);
+			usart_putString("Kalibrierung geloescht\n");
 		}
 
-	
-		uint16_t spannung = (uint16_t)((ADC_Wert * REF_SPANNUNG * 1000) / ADC_MAX_STUFE); // in mV
-		uint16_t prozent = (uint16_t)((ADC_Wert * 100) / adc_max_wert);                   // in %
+		if (calibration_learn(&kalibrierung, ADC_Wert)) {
+			kalibrier_faktor = convert_calibration(kalibrierung.max - kalibrierung.min);
+		}
+		// Schreibt nur, wenn sich Minimum oder Maximum deutlich gendert haben (Lebensdauer des EEPROM)
+		if (calibration_save(&kalibrierung)) {
+			usart_putString("Kalibrierung gespeichert: ");
+			usart_putUnsigned(kalibrierung.min);
+			usart_putString(" .. ");
+			usart_putUnsigned(kalibrierung.max);
+			usart_putChar('\n');
+		}
+
+		uint16_t spannung = convert_millivolt(ADC_Wert); // in mV
+		uint16_t prozent;                                // in %
+		if (calibration_valid(&kalibrierung)) {
+			prozent = convert_calibratedPercent(ADC_Wert - kalibrierung.min, kalibrier_faktor);
+		}
+		else {
+			prozent = convert_percent(ADC_Wert); // noch keine brauchbare Spanne: Anteil am Messbereich
+		}
 
 	
-		lcd_clear();
+		// Bildschirm im Framebuffer aufbauen, lcd_flush() sendet nur die genderten Zeichen
+		lcd_clearBuffer();
+
+		// Zahlen rechtsbndig in Feldern fester Breite, damit der Text daneben nicht springt
+		uint8_t x = lcd_printAt(0, 0, "Spannung:");
+		x = lcd_printAt(x, 0, format_fixed(spannung_string, 5, spannung));
+		lcd_printAt(x, 0, "mV");
 
-		lcd_moveCursor(0, 0);
-		lcd_putString("Spannung: ");
-		lcd_putString(int_to_string(spannung, spannung_string));
-		lcd_putString(" mV");
+		x = lcd_printAt(0, 1, "Prozent: ");
+		x = lcd_printAt(x, 1, format_fixed(prozent_string, 3, prozent));
+		lcd_printAt(x, 1, " %");
 
-		lcd_moveCursor(0, 1);
-		lcd_putString("Prozent: ");
-		lcd_putString(int_to_string(prozent, prozent_string));
-		lcd_putString(" %");
+		lcd_flush();
 
 		_delay_ms(500);
 	}
@@ -7,97 +7,42 @@
 #define F_CPU 4000000UL
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#define BAUD_RATE 9600
+#include "USART.h"
+#include "Power.h"
+#include "Buttons.h"
 
-volatile uint8_t counter_4 = 0;
-volatile uint8_t counter_5 = 0;
-volatile uint8_t counter_6 = 0;
-volatile uint8_t counter_7 = 0;
+// Zeichen pro Taster C4 bis C7 (gesendet beim Loslassen)
+const char zeichen[8] = { [4] = 'K', [5] = 'A', [6] = 'M', [7] = 'U' };
 
-void USART_init(){
-	
-	float baud = (float)((F_CPU << 6) / (16L * BAUD_RATE));
-	USART3.BAUD = baud; // baudrate setzen
-	USART3.CTRLB |= (USART_TXEN_bm | USART_RXEN_bm); // TX und RX aktivieren
-	USART3.CTRLC = USART_CHSIZE_8BIT_gc; // Datenformat( 8-bit )
-}
-
-void USART_Uebertragung(char caracter){
-	
-	while(!(USART3.STATUS & USART_DREIF_bm)){}// Warten bis das Register leer ist
-	USART3.TXDATAL = caracter; // Charakter senden
-}
-
-ISR(PORTC_PORT_vect)
-{
-	
-	if (PORTC.INTFLAGS & PIN4_bm) {
-		if (PORTC.IN & PIN4_bm) {  
-			
-			counter_4++;
-		}
-		PORTC.INTFLAGS = PIN4_bm; 
-	}
-
-	
-	if (PORTC.INTFLAGS & PIN5_bm) {
-		if (PORTC.IN & PIN5_bm) { 
-			
-			counter_5++;
-		}
-		PORTC.INTFLAGS = PIN5_bm;  
-	}
-
-	
-	if (PORTC.INTFLAGS & PIN6_bm) {
-		if (PORTC.IN & PIN6_bm) { 
-			
-			counter_6++;
-		}
-		PORTC.INTFLAGS = PIN6_bm;  
-	}
-
-	if (PORTC.INTFLAGS & PIN7_bm) {
-		if (PORTC.IN & PIN7_bm) {  
-			
-			counter_7++;
-		}
-		PORTC.INTFLAGS = PIN7_bm;  
-	}
+// Ein Ereignis wartet und kann gesendet werden (wird mit gesperrten Interrupts aufgerufen)
+bool arbeit_vorhanden(void){
+	return buttons_pending() && usart_txFree() > 0;
 }
 
 int main(void){
 	
-	PORTC.DIRCLR = PIN4_bm | PIN5_bm | PIN6_bm | PIN7_bm; //Pins C4 bis C7 als Eingnge mit Pull-up-Widerstnden
-	PORTC.PIN4CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
-	PORTC.PIN5CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
-	PORTC.PIN6CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
-	PORTC.PIN7CTRL = PORT_PULLUPEN_bm | PORT_ISC_BOTHEDGES_gc;
+	buttons_initDebounced(PIN4_bm | PIN5_bm | PIN6_bm | PIN7_bm); // Pins C4 bis C7 als Eingnge mit Pull-up-Widerstnden, entprellt
 	
 	PORTF.DIRSET = PIN4_bm;
 	//PORTB.OUTSET = PIN0_bm;
-	USART_init();
+	usart_init();
+	power_init();
 	
 	sei();
 
 	
 	while(1){
-		if (counter_4 > 0) {
-			USART_Uebertragung('K');
-			counter_4--;
-		}
-		if (counter_5 > 0) {
-			USART_Uebertragung('A');
-			counter_5--; 
-		}
-		if (counter_6 > 0) {
-			USART_Uebertragung('M');
-			counter_6--; 
-		}
-		if (counter_7 > 0) {
-			USART_Uebertragung('U');
-			counter_7--; 
-		}
+		// Ereignisse in ihrer Reihenfolge abholen, nur so viele wie in den Sendepuffer passen
+		button_event ereignisse[8];
+		uint8_t frei = usart_txFree();
+		uint8_t anzahl = buttons_read(ereignisse, frei < 8 ? frei : 8);
+		for (uint8_t i = 0; i < anzahl; i++) {
+			if (ereignisse[i].edge == BUTTON_RELEASED) {
+				usart_putChar(zeichen[ereignisse[i].pin]);
+			}
+		}
+		// Schlafen bis zum naechsten Tastendruck; Standby erst, wenn der USART fertig gesendet hat
+		power_sleep(usart_txDone() ? SLEEP_MODE_STANDBY : SLEEP_MODE_IDLE, arbeit_vorhanden);
 	}
 	
 }
@@ -6,39 +6,22 @@
 
 #define F_CPU 4000000UL
 #include <avr/io.h>
-#include <stdio.h>
 #include <avr/interrupt.h>
-#include <util/delay.h>
-#define BAUD_RATE 9600
-#define SCALING_FACTOR 4096
+#include <util/atomic.h>
+#include "USART.h"
+#include "ADC.h"
+#include "Telemetry.h"
+#include "Temperature.h"
+#include "Power.h"
+#include <string.h>
 
-volatile uint32_t sekunde = 0;
-char usart_buffer[64];
+#define ABTASTRATE 50 // Wandlungen pro Sekunde, von TCA1 ueber das Event System gestartet (ohne CPU, ohne Drift)
 
-char* int_to_string(uint16_t number, char* zeichenkette){
-	int position = 0;
-	
-	if(number == 0){
-		zeichenkette[position++] = '0';
-	}
-	if(number < 0){
-		//number = ~number & 1;
-		zeichenkette[position++] = '-';
-	}
-	while(number > 0){
-		zeichenkette[position++] = '0' + number % 10 ;
-		number /= 10;
-	}
-	
-	zeichenkette[position] = '\0'; // string terminator
-	
-	for(int i = 0; i < position /2; i++){
-		char contener = zeichenkette[i];
-		zeichenkette[i] = zeichenkette[position - 1  -i];
-		zeichenkette[position - 1 - i] = contener;
-	}
-	return zeichenkette;
-}
+// Laengste Statuszeile (Messbereich des Sensors -40..125 degC); sie wird erst geschrieben, wenn sie ganz in den Sendepuffer passt
+#define ZEILE_MAX (sizeof("Time: 4294967295 s, Temp: -40.00 degC, 398.15 K, CPU: 100.0 %\n") - 1)
+
+volatile uint32_t sekunde = 0;
+uint32_t letzte_sekunde = 0;
 
 void Timer_init(){
 	
@@ -52,91 +35,103 @@ ISR(TCA0_OVF_vect){
 	TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm; // interupt-flags deaktivieren
 }
 
-void ADC_init(){
-	
-    VREF.ADC0REF = VREF_REFSEL_2V048_gc; // interne referenzspannung fr den Temperatursensor
-	ADC0.CTRLA = ADC_ENABLE_bm | ADC_RESSEL_12BIT_gc; // 12-bit aufloesung und aktivierung
-	ADC0.CTRLC = ADC_PRESC_DIV16_gc; // prescaller ADC
-	ADC0.MUXPOS = ADC_MUXPOS_TEMPSENSE_gc; // Interner Tempratur sensor
-	
-	ADC0.CTRLB = ADC_SAMPNUM_NONE_gc;  // keine Akkumulation
-    ADC0.CTRLD = ADC_INITDLY_DLY64_gc; // initialisierungsverzoegerung >= 25 us
-    ADC0.SAMPCTRL = 28; // sample zeit longueur d echantillonage  >= 28 us
-	
-}
-
-uint16_t ADC_wandlung(){
-	
-	ADC0.COMMAND = ADC_STCONV_bm;
-	while(!(ADC0.INTFLAGS & ADC_RESRDY_bm)){}
-	ADC0.INTFLAGS = ADC_RESRDY_bm;
-	return ADC0.RES;
-}
-
-float ADC_Temperatur(uint16_t adc_wert){
-	
-	uint16_t sigrow_offset = SIGROW.TEMPSENSE1;    // Offset 
-	uint16_t sigrow_slope =  SIGROW.TEMPSENSE0;     // Pente 
-	
-	uint32_t temp = sigrow_offset - adc_wert;
-	temp *= sigrow_slope; // Application de la pente
-	temp += SCALING_FACTOR / 2;  // Aufrunden
-	temp /= SCALING_FACTOR;  // Division pour obtenir la temperature
-	
-	temp =  temp - 273;
-	
-	return (float)temp; // temperatur in celcius
-	
-}
-
-void USART_init(void){
-	float baud = (float)((F_CPU << 6) / (16L * BAUD_RATE));
-	USART3.BAUD = baud;
-	USART3.CTRLB |= (USART_TXEN_bm | USART_RXEN_bm);
-	USART3.CTRLC =  USART_CHSIZE_8BIT_gc;
-}
-
-void USART_Uebertragung(char charakter){
-	
-	while(!(USART3.STATUS & USART_DREIF_bm)){}
-	USART3.TXDATAL = charakter;
-	
-}
+// Interner Temperatursensor
+const adc_channel temperatursensor = {
+	.muxpos = ADC_MUXPOS_TEMPSENSE_gc, // Interner Tempratur sensor
+	.reference = VREF_REFSEL_2V048_gc, // interne referenzspannung fr den Temperatursensor
+	.initdly = ADC_INITDLY_DLY64_gc,   // initialisierungsverzoegerung >= 25 us
+	.sampctrl = 28,                    // sample zeit longueur d echantillonage  >= 28 us
+	.sampnum = ADC_SAMPNUM_ACC16_gc    // Summe von 16 Wandlungen (weniger Rauschen), dauert 2,8 ms von 20 ms
+};
 
 void temp_uebertragung(uint32_t sekunde){
 	
-	uint16_t adc_wert = ADC_wandlung();
-	float temp_c = ADC_Temperatur(adc_wert); // convertion in celcius
-	float temp_k = temp_c + 273; // conversion in kelvin
+	adc_sample messung;
+	while(!adc_latest(0, &messung)){} // letzter Wert der laufenden Wandlungen (nach dem Start auf den ersten warten)
+	
+	// Festkomma in 0,01 degC / 0,01 K, Kalibrierung wurde bei temperature_init() gelesen
+	int32_t temp_c100 = temperature_centiCelsius(messung.value, temperatursensor.sampnum);
+	int32_t temp_k100 = temp_c100 + TEMPERATURE_ZERO_CELSIUS;
+	
+	// Zeile direkt in den Sendepuffer schreiben (ohne snprintf), der Interrupt sendet sie im Hintergrund
+	usart_putString("Time: ");
+	usart_putUnsigned(sekunde);
+	usart_putString(" s, Temp: ");
+	usart_putDecimal(temp_c100, 2);
+	usart_putString(" degC, ");
+	usart_putDecimal(temp_k100, 2);
+	usart_putString(" K, CPU: ");
+	usart_putDecimal(power_dutyCycle(), 1); // Anteil der letzten Sekunde in 0,1 %
+	usart_putString(" %\n");
+	power_resetStatistics();
 	
-	char temp_c_str[16];
-	char temp_k_str[16];
-	int_to_string((uint16_t)(temp_c ), temp_c_str);
-	int_to_string((uint16_t)(temp_k ), temp_k_str);
-	
-	snprintf(usart_buffer, sizeof(usart_buffer),
-		"Time: %lu s, Temp: %s.%d degC, %s.%d K\n",
-		sekunde,
-		temp_c_str , ((uint16_t)(temp_c * 10)) % 10,
-		temp_k_str , ((uint16_t)(temp_k * 10)) % 10); // eine dezimal behalten
+}
 
-		for (int i = 0; usart_buffer[i] != '\0'; i++) {
-			USART_Uebertragung(usart_buffer[i]);
-		}
-	
+// Neue Eingabe oder neue Messwerte (wird mit gesperrten Interrupts aufgerufen)
+bool arbeit_vorhanden(void){
+	if(usart_framePending()){
+		return true;
+	}
+	if(telemetry_getMode() != TELEMETRY_ASCII){
+		return adc_available() > 0;
+	}
+	return sekunde != letzte_sekunde && usart_txFree() >= ZEILE_MAX;
 }
 
 int main(void){
 	
-	USART_init();
+	char befehl[USART_RX_BUFFER_SIZE];
+	
+	usart_init();
 	Timer_init();
-	ADC_init();
+	temperature_init(); // Kalibrierwerte einmal aus der Signature Row lesen
+	adc_init(&temperatursensor, 1);
+	power_init();
 	
-	PORTB.DIRSET = PIN0_bm;
 	sei();
+	if(!adc_startTriggered(ABTASTRATE)){ // Zeitstempel der Messwerte = Nummer der Abtastperiode
+		usart_putString("ADC-Fehler: ABTASTRATE nicht erreichbar\n");
+		usart_flush();
+		while(1){}
+	}
 	
 	while(1){
-		temp_uebertragung(sekunde);
-		_delay_ms(1000);
+		// Umschalten per serieller Eingabe: "bin." = binaere Rohwerte, "delta." = komprimierte Rohwerte,
+		// "text." = eine Textzeile pro Sekunde
+		if(usart_readFrame(befehl, sizeof(befehl))){
+			const char* text = befehl;
+			while(*text == ' ' || *text == '\r' || *text == '\n'){
+				text++; // Zeilenumbruch der vorherigen Eingabe ueberspringen
+			}
+			if(strcmp(text, "bin") == 0){
+				telemetry_setMode(TELEMETRY_BINARY);
+			}
+			else if(strcmp(text, "delta") == 0){
+				telemetry_setMode(TELEMETRY_COMPRESSED);
+			}
+			else if(strcmp(text, "text") == 0){
+				telemetry_setMode(TELEMETRY_ASCII);
+			}
+		}
+		
+		adc_sample messung;
+		if(telemetry_getMode() != TELEMETRY_ASCII){
+			// Wandlungen senden, so schnell wie die Leitung es zulaesst (ueberzaehlige werden verworfen)
+			while(adc_read(&messung) && telemetry_send(&messung)){}
+		}
+		else{
+			uint32_t jetzt;
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+				jetzt = sekunde; // 32-Bit-Wert wird im Interrupt geaendert
+			}
+			if(jetzt != letzte_sekunde && usart_txFree() >= ZEILE_MAX){ // sonst nach dem naechsten gesendeten Byte
+				letzte_sekunde = jetzt;
+				temp_uebertragung(letzte_sekunde);
+				while(adc_read(&messung)){} // Werte der letzten Sekunde verwerfen
+			}
+		}
+		
+		// Schlafen bis zum naechsten Interrupt (Idle: Timer, ADC und USART laufen weiter)
+		power_sleep(SLEEP_MODE_IDLE, arbeit_vorhanden);
 	}
-}
\ No newline at end of file
+}
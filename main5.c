@@ -7,53 +7,14 @@
 #define F_CPU 4000000UL
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#define BAUD_RATE 9600
+#include "USART.h"
+#include "Parse.h"
+#include "Power.h"
 
-char USART_buffer[64];
-volatile uint8_t usart_index = 0;
-volatile uint8_t data_received = 0;
+char befehl[USART_RX_BUFFER_SIZE]; // empfangene Nachricht ohne den abschliessenden '.' ...BITTE DATEN MIT . BEENDEN
 
-
-void USART_init(){
-	float baud = (float)((F_CPU << 6) / (16L * BAUD_RATE));
-	USART3.BAUD = (uint16_t)baud;
-	USART3.CTRLB = USART_TXEN_bm | USART_RXEN_bm;
-	USART3.CTRLC = USART_CHSIZE_8BIT_gc;
-	
-	 // RX interupt aktivieren
-	 USART3.CTRLA |= USART_RXCIE_bm;
-}
-
-void USART_Uebertragung(char charakter){
-	while(!(USART3.STATUS & USART_DREIF_bm)){}
-		USART3.TXDATAL = charakter;
-}
-
-void USART_send_String(char *str){
-	
-	for(size_t i = 0; i < strlen(str); i++){
-		USART_Uebertragung(str[i]);
-	}
-	
-}
-
-ISR(USART3_RXC_vect){
-	char received = USART3_RXDATAL; // empfangene Daten lesen
-	//data_received = 1;
-	if(received == '.'){ // Ende von der Nachricht ...BITTE DATEN MIT . BEENDEN
-		USART_buffer[usart_index++] = '\0';
-		usart_index = 0;
-		data_received = 1; // Signalisiert, dass Daten verfgbar sind
-		USART_send_String("Ende der Nachricht erkannt\n");
-	}
-	else if(usart_index < sizeof(USART_buffer) - 1){
-		USART_buffer[usart_index++] = received;
-	}
-	
-}
+// Lngste Antwort auf eine Nachricht (Fehlerfall); eine Nachricht wird erst gelesen, wenn sie ganz in den Sendepuffer passt
+#define ANTWORT_MAX (sizeof("Ende der Nachricht erkannt\n") - 1 + sizeof("Fehler 9 an Position 255\n") - 1)
 
 void pwm_init(){
 	
@@ -76,36 +37,56 @@ void set_r_g_b(uint8_t r, uint8_t g, uint8_t b){
 	TCA0.SINGLE.CMP2 = b;
 }
 
+// Eine Nachricht wartet und ihre Antwort passt in den Sendepuffer (wird mit gesperrten Interrupts aufgerufen)
+bool antwort_moeglich(void){
+	return usart_framePending() && usart_txFree() >= ANTWORT_MAX;
+}
+
 int main(){
 	
-	USART_init();
+	usart_init(); // RX interrupt wird vom USART-Modul aktiviert
 	pwm_init();
-	//Set RX as input
-	PORTB.DIRCLR = PIN1_bm;
-	
-	PORTB.DIRSET = PIN0_bm;
+	power_init();
 	
 	sei();
 	
-	USART_send_String("RGB Control Ready\n");
+	usart_putString("RGB Control Ready\n");
 	
 	while(1){
-		if(data_received){  // alle daten oder esrte oder eine komplete Nachricht wurde empfangen
-			data_received = 0; //fr die Nachste Nachtricht auf 0 zurcksetzen
+		if(usart_txFree() >= ANTWORT_MAX && usart_readFrame(befehl, sizeof(befehl))){  // eine komplete Nachricht wurde empfangen, weitere bleiben im Empfangspuffer
+			usart_putString("Ende der Nachricht erkannt\n");
 			
 		    // RGB-Werte aus der Eingabe extrahieren
-		    uint8_t r = 0, g = 0, b = 0;
-		    sscanf(USART_buffer, "%hhu,%hhu,%hhu", &r, &g, &b);
+		    uint16_t rgb[3];
+		    uint8_t position;
+		    parse_status status = parse_fields(befehl, rgb, 3, 255, &position);
+			
+			if (status != PARSE_OK) {
+				// ungueltige Eingabe: Farbe bleibt unveraendert, Fehlercode (parse_status) und Position melden
+				usart_putString("Fehler ");
+				usart_putUnsigned(status);
+				usart_putString(" an Position ");
+				usart_putUnsigned(position);
+				usart_putChar('\n');
+				continue;
+			}
 			
 			 // RGB-Werte setzen
-			 set_r_g_b(r, g, b);
+			 set_r_g_b(rgb[0], rgb[1], rgb[2]);
             
 			 
-			 snprintf(USART_buffer, sizeof(USART_buffer), "Set RGB: %d, %d, %d\n", r, g, b);
-			USART_send_String(USART_buffer);
+			usart_putString("Set RGB: ");
+			usart_putUnsigned(rgb[0]);
+			usart_putString(", ");
+			usart_putUnsigned(rgb[1]);
+			usart_putString(", ");
+			usart_putUnsigned(rgb[2]);
+			usart_putChar('\n');
 			
 		
 		}
+		// Schlafen bis zur naechsten Nachricht oder bis der Sender Platz gemacht hat (Idle: die PWM laeuft weiter)
+		power_sleep(SLEEP_MODE_IDLE, antwort_moeglich);
 	}
 	
 }
\ No newline at end of file
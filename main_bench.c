@@ -0,0 +1,370 @@
+/*
+ * Benchmark der zeitkritischen Pfade
+ *
+ * Misst Taktzyklen mit TCA0 (CLK_PER / 1, 16 Bit + Ueberlaufzaehler) direkt auf dem
+ * AVR128DB48 und sendet je Messung eine CSV-Zeile ueber USART3:
+ *
+ *   name,einheit,anzahl,zyklen_pro_einheit,ns_pro_einheit
+ *
+ * Die Zeilen koennen als Baseline gespeichert und nach einer Aenderung mit diff
+ * verglichen werden. Die Zyklen enthalten den Schleifen-Overhead (Zeile "leer"),
+ * Zeilen mit '#' sind Kommentare.
+ * Auf dem AVR folgen zwei Zeilen mit dem Speicherbedarf aus den Linker-Symbolen:
+ *
+ *   flash,byte,<Programm + Initialwerte>,,
+ *   ram,byte,<.data + .bss>,,
+ *
+ * Mit -DBENCH_LIBC entsteht die Vergleichsvariante mit dem bisherigen Code: float statt
+ * Convert, int_to_string/snprintf/atoi statt Format und sscanf statt Parse (auch in der
+ * main5-Verarbeitung). Alle anderen Messungen sind gleich, deren Namen enden auf "_libc".
+ * Nur so zeigt die Differenz der beiden flash-Zeilen die Ersparnis: in einem gemeinsamen
+ * Programm wuerden vfscanf/vfprintf den Vergleich verdecken.
+ *
+ * Host/Bench/baseline.sh baut beide Varianten, haengt die Ausgabe von avr-size und die
+ * groessten Symbole (avr-nm --size-sort) an und speichert die Zeilen von der seriellen
+ * Schnittstelle als Baseline.
+ *
+ * Unter Host/Sim laeuft das Programm ebenfalls, die Zahlen sind dort aber ohne
+ * Bedeutung (die Modelle sind nicht zyklengenau).
+ */
+
+#define F_CPU 4000000UL
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "USART.h"
+#include "ADC.h"
+#include "AVR128DB48_I2C.h"
+#include "I2C_LCD.h"
+#include "Format.h"
+#include "Parse.h"
+#include "Convert.h"
+#include "Filter.h"
+#include "Temperature.h"
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#endif
+
+#define WIEDERHOLUNGEN 100
+
+#ifdef BENCH_LIBC
+#define VARIANTE "_libc"	// an jeden Zeilennamen angehaengt
+#else
+#define VARIANTE ""
+#endif
+
+// Misst die Zyklen fuer anzahl Ausfuehrungen von anweisung
+#define MESSEN(name, einheit, anzahl, anweisung) do {	\
+		usart_flush();									\
+		uint32_t start = zyklen();						\
+		for (uint16_t i = 0; i < (anzahl); i++) {		\
+			anweisung;									\
+		}												\
+		bericht(name, einheit, anzahl, zyklen() - start);	\
+	} while (0)
+
+volatile uint16_t ueberlaeufe = 0;
+
+#ifdef __AVR__
+extern const char __data_load_end;	// Ende von .text + Initialwerten von .data im Flash
+extern char __heap_start;			// Ende von .data + .bss im RAM
+#endif
+
+const adc_channel potentiometer = {
+	.muxpos = ADC_MUXPOS_AIN19_gc,
+	.reference = VREF_REFSEL_VDD_gc,
+	.initdly = ADC_INITDLY_DLY0_gc,
+	.sampctrl = 0
+};
+
+// wie in main4.c
+const adc_channel temperatursensor = {
+	.muxpos = ADC_MUXPOS_TEMPSENSE_gc,
+	.reference = VREF_REFSEL_2V048_gc,
+	.initdly = ADC_INITDLY_DLY64_gc,
+	.sampctrl = 28,
+	.sampnum = ADC_SAMPNUM_ACC16_gc
+};
+
+ISR(TCA0_OVF_vect){
+	ueberlaeufe++;
+	TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
+}
+
+void zaehler_init(){
+	TCA0.SINGLE.PER = 0xFFFF;
+	TCA0.SINGLE.INTCTRL = TCA_SINGLE_OVF_bm;
+	TCA0.SINGLE.CTRLA = TCA_SINGLE_CLKSEL_DIV1_gc | TCA_SINGLE_ENABLE_bm; // ein Zaehlschritt pro CPU-Takt
+}
+
+// 32-Bit-Zykluszaehler aus Ueberlaeufen und CNT
+uint32_t zyklen(){
+	uint16_t hoch;
+	uint16_t tief;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE){
+		hoch = ueberlaeufe;
+		tief = TCA0.SINGLE.CNT;
+		if((TCA0.SINGLE.INTFLAGS & TCA_SINGLE_OVF_bm) && tief < 0x8000){
+			hoch++; // Ueberlauf ist passiert, der Interrupt aber noch nicht gelaufen
+		}
+	}
+	return ((uint32_t)hoch << 16) | tief;
+}
+
+#ifdef BENCH_LIBC
+// Bisherige Zahlenausgabe aus main1.c/main2.c/main4.c (% 10 und / 10 pro Ziffer, danach umdrehen), nur zum Vergleich
+char* int_to_string(uint16_t number, char* zeichenkette) {
+	int position = 0;
+
+	if (number == 0) {
+		zeichenkette[position++] = '0';
+	}
+
+	while (number > 0) {
+		zeichenkette[position++] = '0' + number % 10;
+		number /= 10;
+	}
+
+	zeichenkette[position] = '\0'; // string terminator
+
+	for (int i = 0; i < position / 2; i++) {
+		char contener = zeichenkette[i];
+		zeichenkette[i] = zeichenkette[position - 1 - i];
+		zeichenkette[position - 1 - i] = contener;
+	}
+	return zeichenkette;
+}
+#endif
+
+// Zeile von temp_uebertragung() aus main4.c (mit '#' als Kommentar), ohne das Warten auf den Messwert
+void temp_zeile(uint32_t sekunde, uint16_t wert){
+	int32_t temp_c100 = temperature_centiCelsius(wert, temperatursensor.sampnum);
+	int32_t temp_k100 = temp_c100 + TEMPERATURE_ZERO_CELSIUS;
+
+	usart_putString("# Time: ");
+	usart_putUnsigned(sekunde);
+	usart_putString(" s, Temp: ");
+	usart_putDecimal(temp_c100, 2);
+	usart_putString(" degC, ");
+	usart_putDecimal(temp_k100, 2);
+	usart_putString(" K, CPU: ");
+	usart_putDecimal(1000, 1);
+	usart_putString(" %\n");
+}
+
+// Verarbeitung einer Nachricht wie in main5.c (Antworten mit '#' als Kommentar, PWM ausgelassen)
+#ifdef BENCH_LIBC
+// bisheriger Weg: sscanf und snprintf
+void befehl_antwort(char* befehl){
+	uint8_t r = 0, g = 0, b = 0;
+	char antwort[40];
+
+	usart_putString("# Ende der Nachricht erkannt\n");
+	sscanf(befehl, "%hhu,%hhu,%hhu", &r, &g, &b);
+	snprintf(antwort, sizeof(antwort), "# Set RGB: %d, %d, %d\n", r, g, b);
+	usart_putString(antwort);
+}
+#else
+void befehl_antwort(char* befehl){
+	uint16_t rgb[3];
+	uint8_t position;
+
+	usart_putString("# Ende der Nachricht erkannt\n");
+	parse_status status = parse_fields(befehl, rgb, 3, 255, &position);
+	if(status != PARSE_OK){
+		usart_putString("# Fehler ");
+		usart_putUnsigned(status);
+		usart_putString(" an Position ");
+		usart_putUnsigned(position);
+		usart_putChar('\n');
+		return;
+	}
+	usart_putString("# Set RGB: ");
+	usart_putUnsigned(rgb[0]);
+	usart_putString(", ");
+	usart_putUnsigned(rgb[1]);
+	usart_putString(", ");
+	usart_putUnsigned(rgb[2]);
+	usart_putChar('\n');
+}
+#endif
+
+void bericht(const char* name, const char* einheit, uint16_t anzahl, uint32_t gesamt){
+	uint32_t pro_einheit = (gesamt + anzahl / 2) / anzahl;
+
+	usart_flush(); // Ausgabe der Messung (z.B. temp_uebertragung) zuerst senden
+	usart_putString(name);
+	usart_putString(VARIANTE);
+	usart_putChar(',');
+	usart_putString(einheit);
+	usart_putChar(',');
+	usart_putUnsigned(anzahl);
+	usart_putChar(',');
+	usart_putUnsigned(pro_einheit);
+	usart_putChar(',');
+	usart_putUnsigned((uint32_t)(((uint64_t)gesamt * 1000000000ULL / F_CPU + anzahl / 2) / anzahl));
+	usart_putChar('\n');
+	usart_flush();
+}
+
+// Speicherbedarf als Zeile name,byte,anzahl,,
+void groesse(const char* name, uint32_t bytes){
+	usart_putString(name);
+	usart_putString(VARIANTE);
+	usart_putString(",byte,");
+	usart_putUnsigned(bytes);
+	usart_putString(",,\n");
+	usart_flush();
+}
+
+int main(void){
+
+	char text[FORMAT_DECIMAL_SIZE];
+	char befehl[USART_RX_BUFFER_SIZE];
+#ifdef BENCH_LIBC
+	uint8_t farbe[3];
+#else
+	uint16_t rgb[3];
+#endif
+	filter glaettung;
+	volatile uint16_t ergebnis;
+
+	usart_init();
+	zaehler_init();
+	temperature_init();
+	sei();
+
+	usart_putString("name,einheit,anzahl,zyklen,ns\n");
+#ifdef __AVR__
+	groesse("flash", pgm_get_far_address(__data_load_end));
+	groesse("ram", (uint16_t)&__heap_start - INTERNAL_SRAM_START);
+#else
+	usart_putString("# flash/ram nur auf dem AVR\n");
+#endif
+
+	MESSEN("leer", "durchlauf", WIEDERHOLUNGEN, __asm__ __volatile__ ("" ::: "memory"));
+
+	// Zahlen und Befehle
+#ifdef BENCH_LIBC
+	// bisheriger Weg mit float (AVR: double = float), Integer-Division und libc (zieht vfscanf/vfprintf in den Flash)
+	MESSEN("float_millivolt", "wert", WIEDERHOLUNGEN, ergebnis = (uint16_t)((float)(i * 41) * 3300.0f / 4095.0f + 0.5f));
+	MESSEN("float_percent", "wert", WIEDERHOLUNGEN, ergebnis = (uint16_t)((float)(i * 41) * 100.0f / 4095.0f + 0.5f));
+	MESSEN("div_millivolt", "wert", WIEDERHOLUNGEN, ergebnis = (uint16_t)(((uint32_t)(i * 41) * 3300UL + 2047UL) / 4095UL));
+	MESSEN("int_to_string", "zahl", WIEDERHOLUNGEN, int_to_string(i * 655, text));
+	MESSEN("snprintf", "zahl", WIEDERHOLUNGEN, snprintf(text, sizeof(text), "%u", i * 655));
+	MESSEN("sscanf", "befehl", WIEDERHOLUNGEN, sscanf("255,128,0", "%hhu,%hhu,%hhu", &farbe[0], &farbe[1], &farbe[2]));
+	MESSEN("atoi", "feld", WIEDERHOLUNGEN, ergebnis = atoi("255"));
+#else
+	MESSEN("convert_millivolt", "wert", WIEDERHOLUNGEN, ergebnis = convert_millivolt(i * 41));
+	MESSEN("convert_percent", "wert", WIEDERHOLUNGEN, ergebnis = convert_percent(i * 41));
+	MESSEN("format_u16", "zahl", WIEDERHOLUNGEN, format_u16(text, i * 655));
+	MESSEN("format_decimal", "zahl", WIEDERHOLUNGEN, format_decimal(text, -123456 + i, 1));
+	MESSEN("parse_fields", "befehl", WIEDERHOLUNGEN, parse_fields("255,128,0", rgb, 3, 255, NULL));
+#endif
+
+	// Filter: Kosten pro Messwert, unabhaengig von den Daten
+	filter_init(&glaettung, FILTER_EMA, 3);
+	MESSEN("filter_ema", "messwert", WIEDERHOLUNGEN, ergebnis = filter_update(&glaettung, i * 41));
+	filter_init(&glaettung, FILTER_AVERAGE, 4);
+	MESSEN("filter_average", "messwert", WIEDERHOLUNGEN, ergebnis = filter_update(&glaettung, i * 41));
+	filter_init(&glaettung, FILTER_MEDIAN3, 0);
+	MESSEN("filter_median3", "messwert", WIEDERHOLUNGEN, ergebnis = filter_update(&glaettung, i * 41));
+	filter_init(&glaettung, FILTER_MEDIAN5, 0);
+	MESSEN("filter_median5", "messwert", WIEDERHOLUNGEN, ergebnis = filter_update(&glaettung, i * 41));
+
+	// USART: Kosten im Programm (Puffer) und auf der Leitung
+	// (die gesendeten Zeichen bilden eine Kommentarzeile '#...')
+	uint32_t start = zyklen();
+	for(uint8_t i = 0; i < 32; i++){
+		usart_putChar('#');
+	}
+	uint32_t dauer = zyklen() - start;
+	usart_putChar('\n');
+	bericht("usart_putChar", "byte", 32, dauer);
+
+	start = zyklen();
+	for(uint8_t i = 0; i < 32; i++){
+		usart_putChar('#');
+		usart_flush(); // warten, bis das Byte an den Sender uebergeben ist
+	}
+	dauer = zyklen() - start;
+	usart_putChar('\n');
+	bericht("usart_leitung", "byte", 32, dauer);
+
+	// main5: Nachricht ueber die Leitung (USART-Loopback: TX intern mit RX verbunden), Zerlegen
+	// und Antwort im Sendepuffer; die gesendete Nachricht erscheint als Kommentarzeile
+	uint32_t gesamt = 0;
+	uint32_t verarbeitung = 0;
+	for(uint8_t i = 0; i < 4; i++){
+		usart_putString("# ");
+		while(!usart_txDone()){} // nichts mehr unterwegs, das zurueckkommen koennte
+		USART3.CTRLA |= USART_LBME_bm;
+		start = zyklen();
+		usart_putString("255,128,0.");
+		while(!usart_readFrame(befehl, sizeof(befehl))){}
+		usart_putChar('\n');
+		uint32_t empfangen = zyklen();
+		USART3.CTRLA &= ~USART_LBME_bm;
+		befehl_antwort(befehl);
+		uint32_t ende = zyklen();
+		gesamt += ende - start;
+		verarbeitung += ende - empfangen;
+		usart_flush();
+	}
+	bericht("main5_befehl", "befehl", 4, gesamt);
+	bericht("main5_verarbeitung", "befehl", 4, verarbeitung);
+
+	// ADC: Abstand der Messwerte im Dauerbetrieb (Wandlung + Interrupt) und Abholen aus dem Ringpuffer
+	adc_init(&potentiometer, 1);
+	adc_start();
+	uint8_t vorhanden = adc_available();
+	while(adc_available() == vorhanden){} // auf den Beginn eines Messwerts synchronisieren
+	start = zyklen();
+	vorhanden = adc_available();
+	while(adc_available() < vorhanden + 16){}
+	dauer = zyklen() - start;
+	bericht("adc_wandlung", "messwert", 16, dauer);
+	while(adc_available() < ADC_BUFFER_SIZE - 1){} // Ringpuffer voll
+	adc_stop();
+	adc_sample messung;
+	MESSEN("adc_read", "messwert", ADC_BUFFER_SIZE - 1, adc_read(&messung));
+
+	// Akkumulierte Wandlung wie in main4 (16 Wandlungen pro Messwert)
+	adc_init(&temperatursensor, 1);
+	adc_start();
+	vorhanden = adc_available();
+	while(adc_available() == vorhanden){}
+	start = zyklen();
+	vorhanden = adc_available();
+	while(adc_available() < vorhanden + 4){}
+	dauer = zyklen() - start;
+	bericht("adc_wandlung_acc16", "messwert", 4, dauer);
+	while(!adc_latest(0, &messung)){}
+	adc_stop();
+
+	// main4: Temperatur umrechnen und Zeile in den Sendepuffer schreiben (eine Zeile passt ganz hinein)
+	MESSEN("temp_uebertragung", "zeile", 1, temp_zeile(i, messung.value));
+
+	// LCD: Framebuffer (CPU) und Uebertragung aller 32 Zeichen (I2C)
+	lcd_init();
+	lcd_enable(true);
+	MESSEN("lcd_printAt", "zeile", 2, lcd_printAt(0, i, "0123456789abcdef"));
+	MESSEN("lcd_flush", "bildschirm", 1, lcd_flush());
+	while(i2c_busy()){}
+	lcd_printAt(0, 0, "fedcba9876543210");
+	lcd_printAt(0, 1, "fedcba9876543210");
+	MESSEN("lcd_uebertragung", "bildschirm", 1, lcd_flush(); while(i2c_busy()){});
+	// eine Zeile mit 16 geaenderten Zeichen (ein Cursor-Befehl) und einzelne Zeichen (je ein Cursor-Befehl)
+	lcd_printAt(0, 0, "0123456789abcdef");
+	start = zyklen();
+	lcd_flush();
+	while(i2c_busy()){}
+	bericht("lcd_zeile", "zeichen", 16, zyklen() - start);
+	MESSEN("lcd_zeichen", "zeichen", 16, lcd_printAt(i, 1, "-"); lcd_flush(); while(i2c_busy()){});
+
+	(void)ergebnis;
+	usart_putString("ende\n");
+	while(1){}
+}